@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+/* Checks that galaxy generation stops allocating from the heap once DSPUGEN_ALLOC_CHECK
+ * seeds have warmed up the buffers of a context, with names, planets, veins and gas on,
+ * in the create, batch and sweep paths. Exits with 1 if any seed after that allocates.
+ * Usage: alloccheck */
+
+#include "galaxy.hh"
+#include "gencontext.hh"
+#include "protoset.hh"
+#include "settings.hh"
+#include "util/alloccount.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace dspugen;
+
+void *operator new(std::size_t size) {
+    ++util::heapAllocCount;
+    if (auto *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+static constexpr int StarCount = 64;
+/* Seeds checked after the warm-up, a sweep builds every count from SweepMinStars for each */
+static constexpr int CheckedSeeds = 300;
+static constexpr int SweepMinStars = 32;
+static constexpr int SweepCheckedSeeds = 30;
+static constexpr int BatchSize = 16;
+
+/* Reports the seed if the heap was touched past the warm-up, `processed` being the
+ * galaxies built before it. Returns 1 if so */
+static int checkAllocs(const char *mode, int seed, int processed, uint64_t allocCount) {
+    auto count = util::heapAllocCount - allocCount;
+    if (processed < DSPUGEN_ALLOC_CHECK || count == 0) return 0;
+    fprintf(stderr, "%s: heap allocated %llu times while processing seed %d\n", mode,
+            static_cast<unsigned long long>(count), seed);
+    return 1;
+}
+
+static int checkCreate(const Settings &settings) {
+    GenContext ctx(settings);
+    auto create = Galaxy::creator(settings, StarCount);
+    int failed = 0;
+    for (int seed = 0; seed < DSPUGEN_ALLOC_CHECK + CheckedSeeds; seed++) {
+        auto allocCount = util::heapAllocCount;
+        if (auto *galaxy = create(ctx, DefaultAlgoVersion, seed, StarCount)) galaxy->release();
+        failed += checkAllocs("create", seed, seed, allocCount);
+    }
+    return failed;
+}
+
+static int checkBatch(const Settings &settings) {
+    GenContext ctx(settings);
+    auto batch = Galaxy::batcher(settings, StarCount);
+    std::vector<int> seeds(BatchSize);
+    std::vector<Galaxy *> galaxies(BatchSize);
+    int failed = 0;
+    for (int first = 0; first < DSPUGEN_ALLOC_CHECK + CheckedSeeds; first += BatchSize) {
+        for (int i = 0; i < BatchSize; i++) seeds[i] = first + i;
+        auto allocCount = util::heapAllocCount;
+        batch(ctx, DefaultAlgoVersion, seeds.data(), BatchSize, StarCount, galaxies.data());
+        for (auto *galaxy: galaxies) {
+            if (galaxy) galaxy->release();
+        }
+        failed += checkAllocs("batch", first, first, allocCount);
+    }
+    return failed;
+}
+
+static int checkSweep(const Settings &settings) {
+    GenContext ctx(settings);
+    auto sweep = Galaxy::sweeper(settings);
+    int failed = 0, processed = 0, checked = 0;
+    for (int seed = 0; checked < SweepCheckedSeeds; seed++) {
+        auto allocCount = util::heapAllocCount;
+        sweep(ctx, DefaultAlgoVersion, seed, SweepMinStars, StarCount, [](Galaxy *galaxy, int, void *) {
+            if (galaxy) galaxy->release();
+        }, nullptr);
+        failed += checkAllocs("sweep", seed, processed, allocCount);
+        if (processed >= DSPUGEN_ALLOC_CHECK) checked++;
+        processed += StarCount - SweepMinStars + 1;
+    }
+    return failed;
+}
+
+int main() {
+    loadProtoSets();
+    Settings settings;
+    settings.genName = true;
+    settings.hasPlanets = true;
+    settings.noVeins = false;
+    settings.genGas = true;
+    auto failed = checkCreate(settings) + checkBatch(settings) + checkSweep(settings);
+    printf("%d seeds allocated after the warm-up of %d\n", failed, DSPUGEN_ALLOC_CHECK);
+    return failed > 0 ? 1 : 0;
+}
@@ -8,45 +8,106 @@
 
 #include "galaxy.hh"
 
+#include "gencontext.hh"
+#include "namegen.hh"
 #include "settings.hh"
 #include "util/dotnet35random.hh"
-#include "util/mempool.hh"
+#include "util/threadpool.hh"
 #include "vectors.hh"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace dspugen {
 
 Settings settings;
 
-static thread_local util::MemPool<Galaxy> *gpool;
+/* Uniform grid over the galactic plane with cells as large as the collision
+ * distance, so a candidate only needs checking against the 3x3 cells around it.
+ * Poses are flattened on y, and cells past the border are clamped onto it, which
+ * keeps the lookup exact (clamping never moves two neighbouring cells apart) */
+class PoseGrid {
+public:
+    PoseGrid() noexcept {
+        std::fill(std::begin(heads_), std::end(heads_), -1);
+    }
 
-void Galaxy::initThread() {
-    gpool = new util::MemPool<Galaxy>();
-}
+    /* Both lists never grow past the pose count, reserving it up front
+     * keeps later galaxies from allocating */
+    void reset(int maxCount) {
+        for (auto cell: usedCells_) heads_[cell] = -1;
+        usedCells_.clear();
+        next_.clear();
+        usedCells_.reserve(maxCount);
+        next_.reserve(maxCount);
+    }
 
-void Galaxy::releaseThread() {
-    delete gpool;
-}
+    void insert(const std::vector<VectorLF3> &pts, int index) {
+        const auto &pt = pts[index];
+        auto cell = cellOf(pt.x) * GRID_SIZE + cellOf(pt.z);
+        if (heads_[cell] < 0) usedCells_.push_back(cell);
+        next_.push_back(heads_[cell]);
+        heads_[cell] = index;
+    }
 
-bool CheckCollision(const std::vector<VectorLF3> &pts, const VectorLF3 &pt, double minDist) {
-    double sqrDist = minDist * minDist;
-    for (auto &pt2: pts) {
-        double dx = pt.x - pt2.x;
-        double dy = pt.y - pt2.y;
-        double dz = pt.z - pt2.z;
-        if (dx * dx + dy * dy + dz * dz < sqrDist) return true;
+    [[nodiscard]] bool collides(const std::vector<VectorLF3> &pts, const VectorLF3 &pt, double minDist) const {
+        double sqrDist = minDist * minDist;
+        auto cx = cellOf(pt.x), cz = cellOf(pt.z);
+        auto x1 = std::max(cx - 1, 0), x2 = std::min(cx + 1, GRID_SIZE - 1);
+        auto z1 = std::max(cz - 1, 0), z2 = std::min(cz + 1, GRID_SIZE - 1);
+        for (auto x = x1; x <= x2; x++)
+            for (auto z = z1; z <= z2; z++)
+                for (auto i = heads_[x * GRID_SIZE + z]; i >= 0; i = next_[i]) {
+                    const auto &pt2 = pts[i];
+                    double dx = pt.x - pt2.x;
+                    double dy = pt.y - pt2.y;
+                    double dz = pt.z - pt2.z;
+                    if (dx * dx + dy * dy + dz * dz < sqrDist) return true;
+                }
+        return false;
     }
-    return false;
-}
 
-static void RandomPoses(std::vector<VectorLF3> &tmpPoses, std::vector<VectorLF3> &tmpDrunk, int seed, int maxCount) {
+private:
+    static constexpr int GRID_SIZE = 64;
+    static constexpr double CELL_SIZE = 2.0;
+
+    static inline int cellOf(double v) {
+        auto c = v / CELL_SIZE + GRID_SIZE / 2;
+        if (c < 0.0) return 0;
+        if (c >= GRID_SIZE) return GRID_SIZE - 1;
+        return static_cast<int>(c);
+    }
+
+    int heads_[GRID_SIZE * GRID_SIZE];
+    std::vector<int> next_;
+    std::vector<int> usedCells_;
+};
+
+struct PoseScratch {
+    PoseGrid grid;
+    std::vector<VectorLF3> poses;
+    std::vector<VectorLF3> drunk;
+};
+
+static void RandomPoses(PoseScratch &scratch, std::vector<VectorLF3> &tmpPoses, int seed, int maxCount) {
     constexpr double MIN_DIST = 2.0;
     constexpr double MIN_STEP = 2.0;
     constexpr double MAX_STEP = 3.2;
     constexpr double FLATTEN = 0.18;
+    /* Drunk steps are skipped when the draw is above 0.7, tested on the raw sample */
+    constexpr int RawStay = util::DotNet35Random::rawAbove(0.7);
+    auto &grid = scratch.grid;
+    auto &tmpDrunk = scratch.drunk;
+    grid.reset(maxCount);
+    tmpDrunk.clear();
+    tmpDrunk.reserve(maxCount);
+    tmpPoses.reserve(maxCount);
     util::DotNet35Random dotNet35Random(seed);
     double num = dotNet35Random.nextDouble();
     tmpPoses.emplace_back();
+    grid.insert(tmpPoses, 0);
     int num2 = 6;
     int num3 = 8;
     int num4 = static_cast<int>(num * (num3 - num2) + num2);
@@ -62,9 +123,10 @@ static void RandomPoses(std::vector<VectorLF3> &tmpPoses, std::vector<VectorLF3>
             double num11 = std::sqrt(num10);
             num9 = (num9 * (MAX_STEP - MIN_STEP) + MIN_STEP) / num11;
             VectorLF3 vectorLf { num6 * num9, num7 * num9, num8 * num9 };
-            if (!CheckCollision(tmpPoses, vectorLf, MIN_DIST)) {
+            if (!grid.collides(tmpPoses, vectorLf, MIN_DIST)) {
                 tmpDrunk.emplace_back(vectorLf);
                 tmpPoses.emplace_back(vectorLf);
+                grid.insert(tmpPoses, static_cast<int>(tmpPoses.size()) - 1);
                 if (tmpPoses.size() < maxCount) break;
                 return;
             }
@@ -74,7 +136,7 @@ static void RandomPoses(std::vector<VectorLF3> &tmpPoses, std::vector<VectorLF3>
     int num12 = 0;
     while (num12++ < 256)
         for (auto &drunk: tmpDrunk) {
-            if (dotNet35Random.nextDouble() > 0.7) continue;
+            if (dotNet35Random.nextRaw() >= RawStay) continue;
             int num13 = 0;
             while (num13++ < 256) {
                 double num14 = dotNet35Random.nextDouble() * 2.0 - 1.0;
@@ -89,9 +151,10 @@ static void RandomPoses(std::vector<VectorLF3> &tmpPoses, std::vector<VectorLF3>
                     drunk.x + num14 * num17, drunk.y + num15 * num17,
                     drunk.z + num16 * num17
                 };
-                if (!CheckCollision(tmpPoses, vectorLf2, MIN_DIST)) {
+                if (!grid.collides(tmpPoses, vectorLf2, MIN_DIST)) {
                     drunk = vectorLf2;
                     tmpPoses.emplace_back(vectorLf2);
+                    grid.insert(tmpPoses, static_cast<int>(tmpPoses.size()) - 1);
                     if (tmpPoses.size() < maxCount) break;
                     return;
                 }
@@ -99,143 +162,623 @@ static void RandomPoses(std::vector<VectorLF3> &tmpPoses, std::vector<VectorLF3>
         }
 }
 
-static int GenerateTempPoses(std::vector<VectorLF3> &tmpPoses, std::vector<VectorLF3> &tmpDrunk, int seed, int targetCount) {
-    RandomPoses(tmpPoses, tmpDrunk, seed, targetCount * 4);
-    for (int num = static_cast<int>(tmpPoses.size()) - 1; num >= 0; num--) {
-        if ((num % 4) == 0) { continue; }
-        tmpPoses.erase(tmpPoses.begin() + num);
-        if (tmpPoses.size() <= targetCount) break;
+static int thinPoses(std::vector<VectorLF3> &tmpPoses, int targetCount) {
+    /* The game erases poses whose index is not a multiple of 4 from the back,
+     * one by one, until `targetCount` are left (or just one if already there).
+     * Find where that stops and compact the tail in a single pass. */
+    auto count = static_cast<int>(tmpPoses.size());
+    auto removable = count - (count + 3) / 4;
+    auto toRemove = std::min(count > targetCount ? count - targetCount : 1, removable);
+    auto cut = count;
+    while (toRemove > 0) {
+        if (--cut % 4 != 0) --toRemove;
+    }
+    auto write = cut;
+    for (auto i = cut; i < count; i++) {
+        if (i % 4 == 0) tmpPoses[write++] = tmpPoses[i];
     }
-    return static_cast<int>(tmpPoses.size());
+    tmpPoses.resize(write);
+    return write;
 }
 
-Galaxy::~Galaxy() {
-    for (auto *s: stars) {
-        if (s) s->release();
-    }
+static int GenerateTempPoses(PoseScratch &scratch, std::vector<VectorLF3> &tmpPoses, int seed, int targetCount) {
+    tmpPoses.clear();
+    RandomPoses(scratch, tmpPoses, seed, targetCount * 4);
+    return thinPoses(tmpPoses, targetCount);
 }
 
+static_assert(std::is_trivially_destructible_v<Star> && std::is_trivially_destructible_v<StarCold>,
+              "stars are dropped with their galaxy arena");
+
+/* Nothing in a galaxy needs destructing, the arena blocks, this galaxy
+ * included, just go back to the thread pool */
 void Galaxy::release() {
-    gpool->release(this);
+    auto blocks = std::move(arena);
+    this->~Galaxy();
 }
 
-Galaxy *Galaxy::create(int algoVersion, int galaxySeed, int starCount) {
+/* Generation options fixed at compile time, one set per variant of createGalaxy().
+ * `MaxStars` is the capacity of the per-thread seed arrays, 0 for a dynamic size */
+template<bool NoPositionT, bool BirthOnlyT, bool HasPlanetsT, bool GenNameT, int MaxStarsT>
+struct GenPolicy {
+    static constexpr bool NoPosition = NoPositionT;
+    static constexpr bool BirthOnly = BirthOnlyT;
+    static constexpr bool HasPlanets = HasPlanetsT;
+    static constexpr bool GenName = GenNameT;
+    static constexpr int MaxStars = BirthOnlyT ? 1 : MaxStarsT;
+};
+
+/* Star count covered by the fixed capacity variants, the game's default galaxy size */
+constexpr int FixedMaxStars = 64;
+
+template<int N>
+struct StarSeeds {
+    int seeds[N];
+    int nameSeeds[N];
+    int seeds3[N];
+    int planetSeeds[N];
+    util::DotNet35Random rands[N];
+    EStarType needtypes[N];
+    ESpectrType needSpectrs[N];
+
+    void prepare(int) {}
+};
+
+template<>
+struct StarSeeds<0> {
+    std::vector<int> seeds;
+    std::vector<int> nameSeeds;
+    std::vector<int> seeds3;
+    std::vector<int> planetSeeds;
+    std::vector<util::DotNet35Random> rands;
+    std::vector<EStarType> needtypes;
+    std::vector<ESpectrType> needSpectrs;
+
+    void prepare(int count) {
+        seeds.resize(count);
+        nameSeeds.resize(count);
+        seeds3.resize(count);
+        planetSeeds.resize(count);
+        rands.resize(count);
+        needtypes.resize(count);
+        needSpectrs.resize(count);
+    }
+};
+
+/* What all galaxies of a sweep share: the pose walk of the largest star count and
+ * the star generators drawStarSeeds() leaves in `rands` for it, copied before star
+ * physics draws from them */
+struct SweepScratch {
+    std::vector<VectorLF3> walk;
+    std::vector<util::DotNet35Random> rands;
+};
+
+/* State of each seed of a batch between stages, by slot. `alive` lists the slots
+ * still going, compacted after each stage */
+struct BatchScratch {
+    std::vector<util::DotNet35Random> rands;
+    std::vector<int> poseSeeds;
+    std::vector<int> starCounts;
+    std::vector<std::vector<VectorLF3>> poses;
+    std::vector<GalaxySkeleton> skeletons;
+    std::vector<int> alive;
+
+    void prepare(int count) {
+        rands.resize(count);
+        poseSeeds.resize(count);
+        starCounts.resize(count);
+        poses.resize(count);
+        skeletons.resize(count);
+        alive.resize(count);
+        for (int i = 0; i < count; i++) alive[i] = i;
+    }
+};
+
+struct GenScratch {
+    PoseScratch poses;
+    StarSeeds<FixedMaxStars> fixedSeeds;
+    StarSeeds<0> dynamicSeeds;
+    SweepScratch sweep;
+    BatchScratch batch;
+
+    template<int N>
+    auto &starSeeds() {
+        if constexpr (N == 0) {
+            return dynamicSeeds;
+        } else {
+            static_assert(N <= FixedMaxStars);
+            return fixedSeeds;
+        }
+    }
+};
+
+GenContext::GenContext(const Settings &settings): settings(settings), scratch_(std::make_unique<GenScratch>()) {}
+
+GenContext::~GenContext() = default;
+
+static thread_local std::unique_ptr<GenContext> threadContext;
+
+GenContext &GenContext::threadDefault() {
+    if (!threadContext) threadContext = std::make_unique<GenContext>();
+    threadContext->settings = dspugen::settings;
+    return *threadContext;
+}
+
+void Galaxy::initThread() {
+    GenContext::threadDefault();
+}
+
+void Galaxy::releaseThread() {
+    threadContext.reset();
+}
+
+/* One batch of the star kernel: stars built between two rounds of stream filters,
+ * or by one task of the context pool */
+constexpr int StreamChunk = 16;
+
+/* Runs the stream filters over stars `first` to `end - 1`, building their planets
+ * before `systemFilter` in variants with planets. False once one rejects */
+template<typename P>
+static bool streamStars(GenContext &ctx, Galaxy *galaxy, int first, int end) {
+    for (int i = first; i < end; i++) {
+        const auto *star = galaxy->stars[i];
+        if (ctx.starFilter && !ctx.starFilter(*star, ctx.streamFilterData)) return false;
+        if constexpr (P::HasPlanets) {
+            galaxy->createPlanets(i);
+            if (ctx.systemFilter && !ctx.systemFilter(*star, ctx.streamFilterData)) return false;
+        }
+    }
+    return true;
+}
+
+/* Star seeds are all drawn from the galaxy generator before any star is built,
+ * so both generator levels of every star are seeded in two batched passes.
+ * The first level is also drained of the planet seed here, createStarPlanets()
+ * resumes from that instead of seeding it again */
+template<typename Seeds>
+static void drawStarSeeds(Seeds &scratch, util::DotNet35Random &dotNet35Random, int count) {
+    scratch.prepare(count);
+    auto *seeds = &scratch.seeds[0];
+    auto *nameSeeds = &scratch.nameSeeds[0];
+    auto *seeds3 = &scratch.seeds3[0];
+    auto *planetSeeds = &scratch.planetSeeds[0];
+    auto *rands = &scratch.rands[0];
+    for (int i = 0; i < count; i++) {
+        seeds[i] = dotNet35Random.next();
+    }
+    util::DotNet35Random::seedBatch(rands, seeds, count);
+    for (int i = 0; i < count; i++) {
+        nameSeeds[i] = rands[i].next();
+        seeds3[i] = rands[i].next();
+        rands[i].next();
+        planetSeeds[i] = rands[i].next();
+    }
+    util::DotNet35Random::seedBatch(rands, seeds3, count);
+}
+
+/* Stars 1 to `count - 1` over the context pool, a kernel batch per task. Each task also
+ * leaves the first name try of its stars, names are then settled in star order */
+template<bool GenName, typename Seeds>
+struct PooledStars {
+    Galaxy *galaxy;
+    Seeds &seeds;
+    int count;
+    const VectorLF3 *poses;
+
+    static void task(int index, void *userdata) {
+        auto &job = *static_cast<PooledStars *>(userdata);
+        auto &seeds = job.seeds;
+        auto first = 1 + index * StreamChunk;
+        auto n = std::min(StreamChunk, job.count - first);
+        Star::createStars<false>(job.galaxy, first, n, job.poses, &seeds.seeds[0], &seeds.nameSeeds[0],
+                                 &seeds.planetSeeds[0], &seeds.rands[0], &seeds.needtypes[0],
+                                 &seeds.needSpectrs[0]);
+        if constexpr (GenName) {
+            for (int i = first; i < first + n; i++) {
+                NameGen::firstStarName(seeds.nameSeeds[i], job.galaxy->stars[i]);
+            }
+        }
+    }
+
+    void run(util::ThreadPool &pool) {
+        pool.run((count - 1 + StreamChunk - 1) / StreamChunk, &task, this);
+        if constexpr (GenName) {
+            for (int i = 1; i < count; i++) {
+                NameGen::settleStarName(seeds.nameSeeds[i], galaxy->stars[i], galaxy);
+            }
+        }
+    }
+};
+
+/* Builds the first `count` stars from seeds drawn by drawStarSeeds() */
+template<typename P, typename Seeds>
+static bool buildStars(GenContext &ctx, Galaxy *galaxy, Seeds &scratch, int count, const VectorLF3 *poses) {
+    if (count <= 0) return true;
+    auto *seeds = &scratch.seeds[0];
+    auto *nameSeeds = &scratch.nameSeeds[0];
+    auto *planetSeeds = &scratch.planetSeeds[0];
+    auto *rands = &scratch.rands[0];
+    galaxy->stars[0] = Star::createBirthStar<P::GenName>(galaxy, seeds[0], nameSeeds[0], planetSeeds[0], rands[0]);
+    auto streaming = ctx.starFilter || ctx.systemFilter;
+    if (streaming && !streamStars<P>(ctx, galaxy, 0, 1)) return false;
+    if constexpr (P::BirthOnly) return true;
+    auto *needtypes = &scratch.needtypes[0];
+    auto *needSpectrs = &scratch.needSpectrs[0];
+    const auto &skeleton = galaxy->skeleton;
+    for (int i = 1; i < count; i++) {
+        needtypes[i] = skeleton.starType(i);
+        needSpectrs[i] = skeleton.requestedSpectr(i);
+    }
+    if (!streaming && ctx.pool) {
+        PooledStars<P::GenName, Seeds> {galaxy, scratch, count, poses}.run(*ctx.pool);
+        return true;
+    }
+    if (!streaming) {
+        Star::createStars<P::GenName>(galaxy, 1, count - 1, poses, seeds, nameSeeds,
+                                      planetSeeds, rands, needtypes, needSpectrs);
+        return true;
+    }
+    for (int first = 1; first < count; first += StreamChunk) {
+        auto n = std::min(StreamChunk, count - first);
+        Star::createStars<P::GenName>(galaxy, first, n, poses, seeds, nameSeeds,
+                                      planetSeeds, rands, needtypes, needSpectrs);
+        if (!streamStars<P>(ctx, galaxy, first, first + n)) return false;
+    }
+    return true;
+}
+
+template<typename P>
+static bool createStars(GenContext &ctx, Galaxy *galaxy, util::DotNet35Random &dotNet35Random, const VectorLF3 *poses) {
+    auto count = P::BirthOnly ? std::min(1, galaxy->starCount) : galaxy->starCount;
+    if (count <= 0) return true;
+    auto &scratch = ctx.scratch().starSeeds<P::MaxStars>();
+    drawStarSeeds(scratch, dotNet35Random, count);
+    return buildStars<P>(ctx, galaxy, scratch, count, poses);
+}
+
+/* Hot parts of all stars go in one run, so a scan over them reads contiguous
+ * cache lines, and the cold parts follow. Only stars `first` to `first + count - 1`
+ * get built, the other of the `slots` entries stay null */
+static void allocStars(Galaxy *galaxy, int slots, int first, int count) {
+    auto &arena = galaxy->arena;
+    galaxy->stars.resize(arena, slots);
+    auto *hot = arena.allocArray<Star>(count);
+    auto *colds = arena.allocArray<StarCold>(count);
+    for (int i = 0; i < count; i++) {
+        auto *star = new(hot + i) Star();
+        star->galaxy = galaxy;
+        star->cold = new(colds + i) StarCold();
+        galaxy->stars[first + i] = star;
+    }
+}
+
+/* Galaxy::createAllPlanets(), with the veins split over the context pool if there is
+ * one. Planets are built in star order first, leaving the veins out */
+static void buildPlanets(GenContext &ctx, Galaxy *galaxy) {
+    if (!ctx.pool || galaxy->noVeins) {
+        galaxy->createAllPlanets();
+        return;
+    }
+    auto first = galaxy->planetStars;
+    galaxy->noVeins = true;
+    galaxy->createAllPlanets();
+    galaxy->noVeins = false;
+    struct VeinJob {
+        Galaxy *galaxy;
+        int first;
+    } job {galaxy, first};
+    ctx.pool->run(galaxy->planetStars - first, [](int index, void *userdata) {
+        auto &job = *static_cast<VeinJob *>(userdata);
+        for (auto *planet: job.galaxy->stars[job.first + index]->planets()) planet->generateVeins();
+    }, &job);
+}
+
+/* A galaxy in its own arena with the fields taken from the skeleton and settings,
+ * before any star is allocated. The birth star is always star 1 */
+static Galaxy *allocGalaxy(GenContext &ctx, const GalaxySkeleton &skeleton) {
+    util::Arena arena(&ctx.blockPool());
+    auto *galaxy = arena.create<Galaxy>();
+    galaxy->arena = std::move(arena);
+    galaxy->seed = skeleton.seed;
+    galaxy->starCount = skeleton.starCount;
+    galaxy->noVeins = ctx.settings.noVeins;
+    galaxy->genGas = ctx.settings.genGas;
+    galaxy->skeleton = skeleton;
+    galaxy->birthStarId = 1;
+    return galaxy;
+}
+
+/* A galaxy in its own arena, with room for `count` stars */
+template<typename P>
+static Galaxy *newGalaxy(GenContext &ctx, const GalaxySkeleton &skeleton, int count) {
+    auto *galaxy = allocGalaxy(ctx, skeleton);
+    galaxy->starCountAssumed = P::BirthOnly && !P::NoPosition;
+    allocStars(galaxy, count, 0, count);
+    return galaxy;
+}
+
+template<typename P>
+static Galaxy *createGalaxy(GenContext &ctx, int algoVersion, int galaxySeed, int starCount) {
     util::DotNet35Random dotNet35Random(galaxySeed);
-    if (settings.noPosition) {
-        static const VectorLF3 temp;
+    const VectorLF3 *poses = nullptr;
+    /* The birth star sits at the origin, the walk would only give the star count */
+    if constexpr (P::NoPosition || P::BirthOnly) {
         dotNet35Random.next();
-        auto *galaxy = gpool->alloc();
-        galaxy->seed = galaxySeed;
-        galaxy->starCount = starCount;
-        galaxy->stars.resize(settings.birthOnly ? 1 : starCount);
-
-        auto starCountf = float(starCount);
-        auto num = float(dotNet35Random.nextDouble());
-        auto num2 = float(dotNet35Random.nextDouble());
-        auto num3 = float(dotNet35Random.nextDouble());
-        auto num4 = float(dotNet35Random.nextDouble());
-        auto num5 = int(std::ceil(0.01f * starCountf + num * 0.3f));
-        auto num6 = int(std::ceil(0.01f * starCountf + num2 * 0.3f));
-        auto num7 = int(std::ceil(0.016f * starCountf + num3 * 0.4f));
-        auto num8 = int(std::ceil(0.013f * starCountf + num4 * 1.4f));
-        auto num9 = starCount - num5;
-        auto num10 = num9 - num6;
-        auto num11 = num10 - num7;
-        auto num12 = (num11 - 1) / num8;
-        auto num13 = num12 / 2;
-
-        for (int i = 0; i < starCount; i++) {
-            auto seed = dotNet35Random.next();
-            if (i == 0) {
-                galaxy->stars[i] = Star::createBirthStar(galaxy, seed);
-                galaxy->birthStarId = galaxy->stars[i]->id;
-                if (settings.birthOnly) break;
-                continue;
-            }
+    } else {
+        auto &pscratch = ctx.scratch().poses;
+        auto &tmpPoses = pscratch.poses;
+        starCount = GenerateTempPoses(pscratch, tmpPoses, dotNet35Random.next(), starCount);
+        if (starCount <= 0) { return nullptr; }
+        poses = tmpPoses.data();
+    }
+
+    GalaxySkeleton skeleton;
+    skeleton.build(galaxySeed, starCount, dotNet35Random);
+    if (ctx.skeletonFilter && !ctx.skeletonFilter(skeleton, ctx.skeletonFilterData)) { return nullptr; }
+
+    auto *galaxy = newGalaxy<P>(ctx, skeleton, P::BirthOnly ? 1 : starCount);
+    if (!createStars<P>(ctx, galaxy, dotNet35Random, poses)) {
+        galaxy->release();
+        return nullptr;
+    }
+    if constexpr (P::HasPlanets) {
+        buildPlanets(ctx, galaxy);
+    }
+    return galaxy;
+}
+
+/* Galaxies of one seed for star counts `minStarCount` to `maxStarCount`. A walk stops
+ * once it holds 4 times the star count, so every smaller count walks a prefix of the
+ * largest one, and the galaxy generator draws the same star seeds for all counts.
+ * Only the layout, the thinning of the walk and the stars themselves are redone */
+template<typename P>
+static void sweepGalaxies(GenContext &ctx, int algoVersion, int galaxySeed, int minStarCount, int maxStarCount,
+                          SweepFunc func, void *userdata) {
+    auto &sweep = ctx.scratch().sweep;
+    auto &seeds = ctx.scratch().starSeeds<0>();
+    util::DotNet35Random dotNet35Random(galaxySeed);
+    auto poseSeed = dotNet35Random.next();
+    if constexpr (!P::NoPosition && !P::BirthOnly) {
+        sweep.walk.clear();
+        RandomPoses(ctx.scratch().poses, sweep.walk, poseSeed, maxStarCount * 4);
+    }
+    /* Layout draws are redone for each count, the star seeds come after them */
+    auto layoutRandom = dotNet35Random;
+    GalaxySkeleton skeleton;
+    skeleton.build(galaxySeed, maxStarCount, dotNet35Random);
+    auto maxCount = P::BirthOnly ? std::min(1, maxStarCount) : maxStarCount;
+    if (maxCount > 0) {
+        drawStarSeeds(seeds, dotNet35Random, maxCount);
+        sweep.rands.assign(seeds.rands.begin(), seeds.rands.begin() + maxCount);
+    }
 
-            auto needSpectr = ESpectrType::X;
-            if (i == 3)
-                needSpectr = ESpectrType::M;
-            else if (i == num11 - 1) needSpectr = ESpectrType::O;
-            auto needtype = EStarType::MainSeqStar;
-            if (i % num12 == num13) needtype = EStarType::GiantStar;
-            if (i >= num9)
-                needtype = EStarType::BlackHole;
-            else if (i >= num10)
-                needtype = EStarType::NeutronStar;
-            else if (i >= num11) needtype = EStarType::WhiteDwarf;
-            galaxy->stars[i] = Star::createStar(galaxy, temp, i + 1, seed, needtype, needSpectr);
-        }
-        if (settings.hasPlanets) {
-            for (auto &star: galaxy->stars) {
-                star->createStarPlanets();
+    for (auto requested = minStarCount; requested <= maxStarCount; requested++) {
+        auto starCount = requested;
+        const VectorLF3 *poses = nullptr;
+        if constexpr (!P::NoPosition && !P::BirthOnly) {
+            auto &tmpPoses = ctx.scratch().poses.poses;
+            auto walked = std::min(sweep.walk.size(), static_cast<size_t>(requested) * 4);
+            tmpPoses.assign(sweep.walk.begin(), sweep.walk.begin() + walked);
+            starCount = thinPoses(tmpPoses, requested);
+            if (starCount <= 0) {
+                func(nullptr, requested, userdata);
+                continue;
             }
+            poses = tmpPoses.data();
         }
-        return galaxy;
-    }
-    std::vector<VectorLF3> tmpPoses, tmpDrunk;
-    tmpPoses.reserve(256);
-    tmpDrunk.reserve(256);
-    starCount = GenerateTempPoses(tmpPoses, tmpDrunk, dotNet35Random.next(), starCount);
-    if (starCount <= 0) { return nullptr; }
-
-    auto *galaxy = gpool->alloc();
-    galaxy->seed = galaxySeed;
-    galaxy->starCount = starCount;
-    galaxy->stars.resize(settings.birthOnly ? 1 : starCount);
-
-    auto starCountf = float(starCount);
-    auto num = float(dotNet35Random.nextDouble());
-    auto num2 = float(dotNet35Random.nextDouble());
-    auto num3 = float(dotNet35Random.nextDouble());
-    auto num4 = float(dotNet35Random.nextDouble());
-    auto num5 = int(std::ceil(0.01f * starCountf + num * 0.3f));
-    auto num6 = int(std::ceil(0.01f * starCountf + num2 * 0.3f));
-    auto num7 = int(std::ceil(0.016f * starCountf + num3 * 0.4f));
-    auto num8 = int(std::ceil(0.013f * starCountf + num4 * 1.4f));
-    auto num9 = starCount - num5;
-    auto num10 = num9 - num6;
-    auto num11 = num10 - num7;
-    auto num12 = (num11 - 1) / num8;
-    auto num13 = num12 / 2;
-
-    for (int i = 0; i < starCount; i++) {
-        auto seed = dotNet35Random.next();
-        if (i == 0) {
-            galaxy->stars[i] = Star::createBirthStar(galaxy, seed);
-            galaxy->birthStarId = galaxy->stars[i]->id;
-            if (settings.birthOnly) break;
+        auto rand = layoutRandom;
+        skeleton.build(galaxySeed, starCount, rand);
+        if (ctx.skeletonFilter && !ctx.skeletonFilter(skeleton, ctx.skeletonFilterData)) {
+            func(nullptr, requested, userdata);
             continue;
         }
+        auto count = P::BirthOnly ? std::min(1, starCount) : starCount;
+        auto *galaxy = newGalaxy<P>(ctx, skeleton, P::BirthOnly ? 1 : starCount);
+        std::copy_n(sweep.rands.begin(), count, seeds.rands.begin());
+        if (!buildStars<P>(ctx, galaxy, seeds, count, poses)) {
+            galaxy->release();
+            func(nullptr, requested, userdata);
+            continue;
+        }
+        if constexpr (P::HasPlanets) {
+            buildPlanets(ctx, galaxy);
+        }
+        func(galaxy, requested, userdata);
+    }
+}
+
+/* Same galaxies as createGalaxy() for a batch of seeds, built stage by stage over the
+ * whole batch: galaxy generators, poses, layouts, stars and planets. Seeds dropped by a
+ * stage (no star placed, rejected by a filter) leave the survivor list before the next */
+template<typename P>
+static int createBatch(GenContext &ctx, int algoVersion, const int *galaxySeeds, int count, int starCount,
+                       Galaxy **galaxies) {
+    auto &batch = ctx.scratch().batch;
+    batch.prepare(count);
+    std::fill_n(galaxies, count, nullptr);
+    auto &alive = batch.alive;
+    auto survivors = count;
+
+    util::DotNet35Random::seedBatch(batch.rands.data(), galaxySeeds, count);
+    for (int i = 0; i < count; i++) {
+        batch.poseSeeds[i] = batch.rands[i].next();
+        batch.starCounts[i] = starCount;
+    }
+
+    if constexpr (!P::NoPosition && !P::BirthOnly) {
+        auto kept = 0;
+        for (int k = 0; k < survivors; k++) {
+            auto i = alive[k];
+            auto &poses = batch.poses[i];
+            poses.clear();
+            RandomPoses(ctx.scratch().poses, poses, batch.poseSeeds[i], starCount * 4);
+            batch.starCounts[i] = thinPoses(poses, starCount);
+            if (batch.starCounts[i] > 0) alive[kept++] = i;
+        }
+        survivors = kept;
+    }
 
-        auto needSpectr = ESpectrType::X;
-        if (i == 3)
-            needSpectr = ESpectrType::M;
-        else if (i == num11 - 1) needSpectr = ESpectrType::O;
-        auto needtype = EStarType::MainSeqStar;
-        if (i % num12 == num13) needtype = EStarType::GiantStar;
-        if (i >= num9)
-            needtype = EStarType::BlackHole;
-        else if (i >= num10)
-            needtype = EStarType::NeutronStar;
-        else if (i >= num11) needtype = EStarType::WhiteDwarf;
-        galaxy->stars[i] = Star::createStar(galaxy, tmpPoses[i], i + 1, seed, needtype, needSpectr);
+    {
+        auto kept = 0;
+        for (int k = 0; k < survivors; k++) {
+            auto i = alive[k];
+            auto &skeleton = batch.skeletons[i];
+            skeleton.build(galaxySeeds[i], batch.starCounts[i], batch.rands[i]);
+            if (ctx.skeletonFilter && !ctx.skeletonFilter(skeleton, ctx.skeletonFilterData)) continue;
+            alive[kept++] = i;
+        }
+        survivors = kept;
+    }
+
+    {
+        auto kept = 0;
+        for (int k = 0; k < survivors; k++) {
+            auto i = alive[k];
+            auto *galaxy = newGalaxy<P>(ctx, batch.skeletons[i], P::BirthOnly ? 1 : batch.starCounts[i]);
+            const VectorLF3 *poses = nullptr;
+            if constexpr (!P::NoPosition && !P::BirthOnly) poses = batch.poses[i].data();
+            if (!createStars<P>(ctx, galaxy, batch.rands[i], poses)) {
+                galaxy->release();
+                continue;
+            }
+            galaxies[i] = galaxy;
+            alive[kept++] = i;
+        }
+        survivors = kept;
+    }
+
+    if constexpr (P::HasPlanets) {
+        for (int k = 0; k < survivors; k++) {
+            buildPlanets(ctx, galaxies[alive[k]]);
+        }
     }
-    if (settings.hasPlanets) {
-        for (auto &star: galaxy->stars) {
-            star->createStarPlanets();
+    return survivors;
+}
+
+void Galaxy::createPlanets(int starIndex) {
+    starIndex = std::min(starIndex, static_cast<int>(stars.size()) - 1);
+    for (; planetStars <= starIndex; planetStars++) {
+        /* Stars skipped by createStarOnly() stop the prefix */
+        auto *star = stars[planetStars];
+        if (!star) break;
+        star->createStarPlanets();
+        if (genGas) {
+            for (auto *planet: star->planets()) planet->generateGas();
         }
     }
+}
+
+Galaxy *Galaxy::verifyStarCount(GenContext &ctx, int algoVersion) {
+    if (!starCountAssumed) return this;
+    util::DotNet35Random dotNet35Random(seed);
+    auto &pscratch = ctx.scratch().poses;
+    auto count = GenerateTempPoses(pscratch, pscratch.poses, dotNet35Random.next(), starCount);
+    if (count == starCount) {
+        starCountAssumed = false;
+        return this;
+    }
+    auto galaxySeed = seed;
+    release();
+    if (count <= 0) return nullptr;
+    /* The birth system only depends on the count, so taking it as requested is exact now */
+    auto *galaxy = create(ctx, algoVersion, galaxySeed, count);
+    if (galaxy) galaxy->starCountAssumed = false;
     return galaxy;
 }
 
-int Galaxy::GeneratePoses(int algoVersion, int galaxySeed, int starCount, std::vector<VectorLF3> &poses) {
+template<bool... Flags>
+static GalaxyCreateFunc pickCreator(const bool *flags, int starCount) {
+    if constexpr (sizeof...(Flags) == 4) {
+        if (starCount <= FixedMaxStars) return &createGalaxy<GenPolicy<Flags..., FixedMaxStars>>;
+        return &createGalaxy<GenPolicy<Flags..., 0>>;
+    } else {
+        return flags[0] ? pickCreator<Flags..., true>(flags + 1, starCount)
+                        : pickCreator<Flags..., false>(flags + 1, starCount);
+    }
+}
+
+GalaxyCreateFunc Galaxy::creator(const Settings &settings, int starCount) {
+    const bool flags[4] = {settings.noPosition, settings.birthOnly, settings.hasPlanets, settings.genName};
+    return pickCreator<>(flags, starCount);
+}
+
+template<bool... Flags>
+static GalaxySweepFunc pickSweeper(const bool *flags) {
+    if constexpr (sizeof...(Flags) == 4) {
+        return &sweepGalaxies<GenPolicy<Flags..., 0>>;
+    } else {
+        return flags[0] ? pickSweeper<Flags..., true>(flags + 1)
+                        : pickSweeper<Flags..., false>(flags + 1);
+    }
+}
+
+template<bool... Flags>
+static GalaxyBatchFunc pickBatcher(const bool *flags, int starCount) {
+    if constexpr (sizeof...(Flags) == 4) {
+        if (starCount <= FixedMaxStars) return &createBatch<GenPolicy<Flags..., FixedMaxStars>>;
+        return &createBatch<GenPolicy<Flags..., 0>>;
+    } else {
+        return flags[0] ? pickBatcher<Flags..., true>(flags + 1, starCount)
+                        : pickBatcher<Flags..., false>(flags + 1, starCount);
+    }
+}
+
+GalaxyBatchFunc Galaxy::batcher(const Settings &settings, int starCount) {
+    const bool flags[4] = {settings.noPosition, settings.birthOnly, settings.hasPlanets, settings.genName};
+    return pickBatcher<>(flags, starCount);
+}
+
+GalaxySweepFunc Galaxy::sweeper(const Settings &settings) {
+    const bool flags[4] = {settings.noPosition, settings.birthOnly, settings.hasPlanets, settings.genName};
+    return pickSweeper<>(flags);
+}
+
+Galaxy *Galaxy::create(GenContext &ctx, int algoVersion, int galaxySeed, int starCount) {
+    return creator(ctx.settings, starCount)(ctx, algoVersion, galaxySeed, starCount);
+}
+
+Galaxy *Galaxy::create(int algoVersion, int galaxySeed, int starCount) {
+    return create(GenContext::threadDefault(), algoVersion, galaxySeed, starCount);
+}
+
+Star *Galaxy::createStarOnly(GenContext &ctx, int algoVersion, int galaxySeed, int starCount, int index) {
+    static const VectorLF3 origin;
     util::DotNet35Random dotNet35Random(galaxySeed);
-    std::vector<VectorLF3> tmpDrunk;
-    poses.clear();
-    poses.reserve(256);
-    tmpDrunk.reserve(256);
-    return GenerateTempPoses(poses, tmpDrunk, dotNet35Random.next(), starCount);
+    auto poseSeed = dotNet35Random.next();
+    const VectorLF3 *poses = nullptr;
+    if (!ctx.settings.noPosition) {
+        auto &pscratch = ctx.scratch().poses;
+        starCount = GenerateTempPoses(pscratch, pscratch.poses, poseSeed, starCount);
+        poses = pscratch.poses.data();
+    }
+    if (index < 0 || index >= starCount) { return nullptr; }
+    GalaxySkeleton skeleton;
+    skeleton.build(galaxySeed, starCount, dotNet35Random);
+    /* A name clashing with an earlier star is rolled again, so names need those stars too */
+    auto first = ctx.settings.genName ? 0 : index;
+
+    auto *galaxy = allocGalaxy(ctx, skeleton);
+    allocStars(galaxy, starCount, first, index + 1 - first);
+    for (int i = 0; i <= index; i++) {
+        auto seed = dotNet35Random.next();
+        if (i < first) continue;
+        if (i == 0) {
+            Star::createBirthStar(ctx, galaxy, seed);
+        } else {
+            Star::createStar(ctx, galaxy, poses ? poses[i] : origin, i + 1, seed,
+                             skeleton.starType(i), skeleton.requestedSpectr(i));
+        }
+    }
+    return galaxy->stars[index];
+}
+
+int Galaxy::GeneratePoses(GenContext &ctx, int algoVersion, int galaxySeed, int starCount, std::vector<VectorLF3> &poses) {
+    util::DotNet35Random dotNet35Random(galaxySeed);
+    return GenerateTempPoses(ctx.scratch().poses, poses, dotNet35Random.next(), starCount);
+}
+
+int Galaxy::GeneratePoses(int algoVersion, int galaxySeed, int starCount, std::vector<VectorLF3> &poses) {
+    return GeneratePoses(GenContext::threadDefault(), algoVersion, galaxySeed, starCount, poses);
 }
 
 }
@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include "galaxyskeleton.hh"
 #include "star.hh"
+#include "util/arena.hh"
 #include <vector>
 
 namespace dspugen {
@@ -17,11 +19,51 @@ enum : int {
     DefaultAlgoVersion = 20200403,
 };
 
+struct Settings;
+struct GalaxyView;
+class GenContext;
+class Galaxy;
+
+using GalaxyCreateFunc = Galaxy *(*)(GenContext &ctx, int algoVersion, int galaxySeed, int starCount);
+/* Gets each galaxy of a sweep in star count order and owns it, `galaxy` is nullptr
+ * where create() would have returned nullptr */
+using SweepFunc = void (*)(Galaxy *galaxy, int starCount, void *userdata);
+/* Fills `galaxies[i]` for `galaxySeeds[i]`, nullptr where create() would have returned
+ * nullptr, and returns how many galaxies were built */
+using GalaxyBatchFunc = int (*)(GenContext &ctx, int algoVersion, const int *galaxySeeds, int count, int starCount,
+                                Galaxy **galaxies);
+using GalaxySweepFunc = void (*)(GenContext &ctx, int algoVersion, int galaxySeed, int minStarCount,
+                                 int maxStarCount, SweepFunc func, void *userdata);
+
 class Galaxy {
 public:
     static constexpr double AU = 40000.0;
     static constexpr double LY = 2400000.0;
 
+    /* Same as `creator(ctx.settings, starCount)(ctx, algoVersion, galaxySeed, starCount)`.
+     * Returns nullptr if no star could be placed or a filter of `ctx` rejects the galaxy */
+    static Galaxy *create(GenContext &ctx, int algoVersion, int galaxySeed, int starCount);
+    /* Galaxy generator specialized at compile time for the given settings,
+     * pick it once before a run instead of testing the settings per galaxy */
+    static GalaxyCreateFunc creator(const Settings &settings, int starCount);
+    /* Same galaxies as create() for each star count from `minStarCount` to `maxStarCount`,
+     * with the pose walk and star seeds of the seed computed once for all of them.
+     * Stream filters of the context run as in create() */
+    static GalaxySweepFunc sweeper(const Settings &settings);
+    /* Same galaxies as create() for a batch of seeds, with each stage (generators, poses,
+     * layouts, stars, planets) run over the whole batch before the next one */
+    static GalaxyBatchFunc batcher(const Settings &settings, int starCount);
+    /* Only the star at `index` of the galaxy, as create() would build it, without planets.
+     * With `ctx.settings.noPosition` no pose is generated, the star count is taken as is
+     * and the position left at the origin. With `ctx.settings.genName` the stars before it
+     * are built too, for the name clash checks. Other entries of `stars` stay null, release
+     * the star with `star->galaxy->release()`. Returns nullptr if `index` is out of range */
+    static Star *createStarOnly(GenContext &ctx, int algoVersion, int galaxySeed, int starCount, int index);
+    static int GeneratePoses(GenContext &ctx, int algoVersion, int galaxySeed, int starCount,
+                             std::vector<VectorLF3> &poses);
+
+    /* Compatibility with callers not passing a context, these use
+     * GenContext::threadDefault() and the global `settings` */
     static Galaxy *create(int algoVersion, int galaxySeed, int starCount);
     static int GeneratePoses(int algoVersion, int galaxySeed, int starCount, std::vector<VectorLF3>& poses);
 
@@ -29,8 +71,16 @@ public:
     static void initThread();
     static void releaseThread();
 
-    ~Galaxy();
     void release();
+    /* Build planets of the stars up to `starIndex`, with those of earlier stars first.
+     * Filters looking at the first stars only no longer pay for the whole galaxy */
+    void createPlanets(int starIndex);
+    inline void createAllPlanets() { createPlanets(static_cast<int>(stars.size()) - 1); }
+    /* Birth-only galaxies skip the pose walk and take the requested star count, which
+     * the walk may lower. This runs the walk to check it, meant for galaxies kept by the
+     * filters. Returns this galaxy if the count holds, otherwise releases it and returns
+     * it built again with the real count, or nullptr like create() */
+    Galaxy *verifyStarCount(GenContext &ctx, int algoVersion);
 /*
     int birthPlanetId = 0;
 */
@@ -38,8 +88,24 @@ public:
     int HabitableCount = 0;
     int seed = 0;
     int starCount = 0;
+    /* Stars at the front whose planets are built. Planet types depend on the
+     * HabitableCount left by every earlier star, so planets only grow in star order */
+    int planetStars = 0;
+    /* `starCount` is the requested one, see verifyStarCount() */
+    bool starCountAssumed = false;
+    /* Planet options of the settings the galaxy was made with, for planets built later */
+    bool noVeins = false;
+    bool genGas = false;
+    GalaxySkeleton skeleton;
 
-    std::vector<Star *> stars;
+    util::ArenaArray<Star *> stars;
+    /* Named stars hashed by name for the clash checks of NameGen, which allocates it
+     * on first use. Open addressing, empty slots are null */
+    util::ArenaArray<Star *> nameSlots;
+    /* Holds this galaxy with its stars, planets and their arrays, dropped at once by release() */
+    util::Arena arena;
+    /* Structure of arrays copy, built on demand by GalaxyView::get() */
+    GalaxyView *view = nullptr;
 
     [[nodiscard]] inline Star *starById(int starId) const {
         auto num = starId - 1;
@@ -53,8 +119,9 @@ public:
         if (num < 0 || num >= stars.size()) return nullptr;
         auto star = stars[num];
         if (!star) return nullptr;
-        if (num2 < 0 || num2 >= star->planets.size()) return nullptr;
-        return star->planets[num2];
+        const auto &planets = star->planets();
+        if (num2 < 0 || num2 >= planets.size()) return nullptr;
+        return planets[num2];
     }
 };
 
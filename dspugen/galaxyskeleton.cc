@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+#include "galaxyskeleton.hh"
+
+#include "util/dotnet35random.hh"
+#include <cmath>
+
+namespace dspugen {
+
+void GalaxySkeleton::build(int galaxySeed, int count, util::DotNet35Random &dotNet35Random) {
+    seed = galaxySeed;
+    starCount = count;
+    auto starCountf = float(count);
+    auto num = float(dotNet35Random.nextDouble());
+    auto num2 = float(dotNet35Random.nextDouble());
+    auto num3 = float(dotNet35Random.nextDouble());
+    auto num4 = float(dotNet35Random.nextDouble());
+    auto num5 = int(std::ceil(0.01f * starCountf + num * 0.3f));
+    auto num6 = int(std::ceil(0.01f * starCountf + num2 * 0.3f));
+    auto num7 = int(std::ceil(0.016f * starCountf + num3 * 0.4f));
+    auto num8 = int(std::ceil(0.013f * starCountf + num4 * 1.4f));
+    blackHoleFrom = count - num5;
+    neutronStarFrom = blackHoleFrom - num6;
+    whiteDwarfFrom = neutronStarFrom - num7;
+    giantPeriod = (whiteDwarfFrom - 1) / num8;
+    giantPhase = giantPeriod / 2;
+
+    mainSeqCount = count > 0 ? 1 : 0;
+    giantCount = whiteDwarfCount = neutronStarCount = blackHoleCount = 0;
+    for (int i = 1; i < count; i++) {
+        switch (starType(i)) {
+            case EStarType::MainSeqStar:
+                ++mainSeqCount;
+                break;
+            case EStarType::GiantStar:
+                ++giantCount;
+                break;
+            case EStarType::WhiteDwarf:
+                ++whiteDwarfCount;
+                break;
+            case EStarType::NeutronStar:
+                ++neutronStarCount;
+                break;
+            case EStarType::BlackHole:
+                ++blackHoleCount;
+                break;
+        }
+    }
+}
+
+}
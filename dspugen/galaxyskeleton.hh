@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+#pragma once
+
+#include "star.hh"
+
+namespace dspugen {
+
+namespace util {
+class DotNet35Random;
+}
+
+/* Star layout of a galaxy, known from the galaxy seed and star count before any star
+ * is built. Stars past the birth star get a required type by index: black holes at the
+ * end, then neutron stars, then white dwarfs, and giants spread evenly over the rest.
+ * Required types are final, the star physics always lands on them.
+ * Spectra are only requested (M for star index 3, O for the last star before the white
+ * dwarfs), the physics decides the actual one */
+struct GalaxySkeleton {
+    static constexpr int MStarIndex = 3;
+
+    int seed = 0;
+    int starCount = 0;
+
+    /* Stars at or after these indices are of the given type */
+    int whiteDwarfFrom = 0;
+    int neutronStarFrom = 0;
+    int blackHoleFrom = 0;
+    /* Below `whiteDwarfFrom`, stars with `index % giantPeriod == giantPhase` are giants,
+     * none if the period is 0, as with very few stars */
+    int giantPeriod = 1;
+    int giantPhase = 0;
+
+    /* Stars of each type, the birth star counted as a main sequence star */
+    int mainSeqCount = 0;
+    int giantCount = 0;
+    int whiteDwarfCount = 0;
+    int neutronStarCount = 0;
+    int blackHoleCount = 0;
+
+    /* Draw the layout from the galaxy generator, which must be right after the pose seed */
+    void build(int galaxySeed, int count, util::DotNet35Random &dotNet35Random);
+
+    [[nodiscard]] inline int oStarIndex() const { return whiteDwarfFrom - 1; }
+
+    [[nodiscard]] inline EStarType starType(int index) const {
+        if (index == 0) return EStarType::MainSeqStar;
+        if (index >= blackHoleFrom) return EStarType::BlackHole;
+        if (index >= neutronStarFrom) return EStarType::NeutronStar;
+        if (index >= whiteDwarfFrom) return EStarType::WhiteDwarf;
+        if (giantPeriod > 0 && index % giantPeriod == giantPhase) return EStarType::GiantStar;
+        return EStarType::MainSeqStar;
+    }
+
+    [[nodiscard]] inline ESpectrType requestedSpectr(int index) const {
+        if (index == 0) return ESpectrType::X;
+        if (index == MStarIndex) return ESpectrType::M;
+        if (index == oStarIndex()) return ESpectrType::O;
+        return ESpectrType::X;
+    }
+};
+
+}
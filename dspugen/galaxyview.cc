@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+#include "galaxyview.hh"
+
+#include "galaxy.hh"
+#include <algorithm>
+
+namespace dspugen {
+
+template<typename T>
+static T *allocLanes(util::Arena &arena, int stride, T fill) {
+    auto *arr = static_cast<T *>(arena.alloc(sizeof(T) * stride, 64));
+    std::fill(arr, arr + stride, fill);
+    return arr;
+}
+
+static inline int padLanes(int count) {
+    return (count + GalaxyView::kLanes - 1) / GalaxyView::kLanes * GalaxyView::kLanes;
+}
+
+const GalaxyView *GalaxyView::get(Galaxy *galaxy, bool withPlanets) {
+    auto *view = galaxy->view;
+    if (view && (view->hasPlanets || !withPlanets)) return view;
+
+    auto &stars = galaxy->stars;
+    if (withPlanets) galaxy->createAllPlanets();
+
+    auto &arena = galaxy->arena;
+    view = arena.create<GalaxyView>();
+    auto starCount = static_cast<int>(stars.size());
+    auto starStride = padLanes(starCount);
+    auto *type = allocLanes<int8_t>(arena, starStride, -1);
+    auto *spectr = allocLanes<int8_t>(arena, starStride, -1);
+    auto *luminosity = allocLanes<float>(arena, starStride, 0.0f);
+    auto *dysonRadius = allocLanes<float>(arena, starStride, 0.0f);
+    auto *x = allocLanes<double>(arena, starStride, 0.0);
+    auto *y = allocLanes<double>(arena, starStride, 0.0);
+    auto *z = allocLanes<double>(arena, starStride, 0.0);
+    for (int i = 0; i < starCount; i++) {
+        const auto *star = stars[i];
+        type[i] = static_cast<int8_t>(star->type);
+        spectr[i] = static_cast<int8_t>(star->spectr);
+        luminosity[i] = star->luminosity;
+        dysonRadius[i] = star->dysonRadius;
+        x[i] = star->position.x;
+        y[i] = star->position.y;
+        z[i] = star->position.z;
+    }
+    view->starCount = starCount;
+    view->starStride = starStride;
+    view->type = type;
+    view->spectr = spectr;
+    view->luminosity = luminosity;
+    view->dysonRadius = dysonRadius;
+    view->x = x;
+    view->y = y;
+    view->z = z;
+
+    auto *planetStart = allocLanes<int32_t>(arena, starCount + 1, 0);
+    int planetCount = 0;
+    if (withPlanets) {
+        for (int i = 0; i < starCount; i++) {
+            planetStart[i] = planetCount;
+            planetCount += static_cast<int>(stars[i]->planets().size());
+        }
+    }
+    planetStart[starCount] = planetCount;
+    auto planetStride = padLanes(planetCount);
+    auto *planetStar = allocLanes<int16_t>(arena, planetStride, -1);
+    auto *theme = allocLanes<int16_t>(arena, planetStride, -1);
+    auto *singularity = allocLanes<int32_t>(arena, planetStride, 0);
+    auto *veinSpot = allocLanes<int32_t>(arena, planetStride * 15, 0);
+    if (withPlanets) {
+        int index = 0;
+        for (int i = 0; i < starCount; i++) {
+            for (const auto *planet: stars[i]->planets()) {
+                planetStar[index] = static_cast<int16_t>(i);
+                theme[index] = static_cast<int16_t>(planet->theme);
+                singularity[index] = planet->singularity;
+                for (int v = 0; v < 15; v++) {
+                    veinSpot[v * planetStride + index] = planet->veinSpot[v];
+                }
+                index++;
+            }
+        }
+    }
+    view->planetCount = planetCount;
+    view->planetStride = planetStride;
+    view->planetStart = planetStart;
+    view->planetStar = planetStar;
+    view->theme = theme;
+    view->singularity = singularity;
+    view->veinSpot = veinSpot;
+    view->hasPlanets = withPlanets;
+    galaxy->view = view;
+    return view;
+}
+
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace dspugen {
+
+class Galaxy;
+
+/* Structure of arrays copy of a galaxy, for filters testing every star or planet
+ * against the same condition. Arrays are 64-byte aligned and padded to a multiple
+ * of kLanes entries. Padding entries have type/spectr/theme -1 and zeros elsewhere,
+ * so loops can run over the padded count without a scalar tail */
+struct GalaxyView {
+    static constexpr int kLanes = 64;
+
+    int starCount;
+    int starStride;
+    const int8_t *type;
+    const int8_t *spectr;
+    const float *luminosity;
+    const float *dysonRadius;
+    const double *x;
+    const double *y;
+    const double *z;
+
+    /* Planets in star order, those of star i are [planetStart[i], planetStart[i + 1]).
+     * All counts are 0 if the view was built without planets */
+    int planetCount;
+    int planetStride;
+    const int32_t *planetStart;
+    const int16_t *planetStar;
+    const int16_t *theme;
+    const int32_t *singularity;
+    /* veinSpot[v * planetStride + i] is veinSpot[v] of planet i */
+    const int32_t *veinSpot;
+    bool hasPlanets;
+
+    [[nodiscard]] inline const int32_t *veinSpotOf(int vein) const { return veinSpot + vein * planetStride; }
+
+    /* Built once per galaxy in its arena. `withPlanets` generates missing planets first */
+    static const GalaxyView *get(Galaxy *galaxy, bool withPlanets);
+};
+
+}
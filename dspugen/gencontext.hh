@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+#pragma once
+
+#include "settings.hh"
+#include "util/arena.hh"
+#include <memory>
+
+namespace dspugen {
+
+namespace util {
+class ThreadPool;
+}
+
+struct GalaxySkeleton;
+class Star;
+/* Scratch buffers reused across galaxies, defined in galaxy.cc */
+struct GenScratch;
+
+/* Returns false to drop a galaxy before its stars are built */
+using SkeletonFilterFunc = bool (*)(const GalaxySkeleton &skeleton, void *userdata);
+/* Returns false to drop a galaxy while its stars are built */
+using StarStreamFunc = bool (*)(const Star &star, void *userdata);
+
+/* State of one generation loop: the options, the arena block pool galaxies are
+ * allocated from and the scratch buffers. A context is used by one thread at a time
+ * and must outlive the galaxies created from it. Nothing is tied to the thread,
+ * so one thread can run several contexts with different settings side by side */
+class GenContext final {
+public:
+    explicit GenContext(const Settings &settings = Settings());
+    ~GenContext();
+    GenContext(const GenContext &) = delete;
+    GenContext &operator=(const GenContext &) = delete;
+
+    /* Context of the calls made without one, created on first use (or by
+     * Galaxy::initThread()) and released by Galaxy::releaseThread().
+     * Its settings are copied from the global `settings` on each call */
+    static GenContext &threadDefault();
+
+    [[nodiscard]] inline util::ArenaBlockPool &blockPool() { return blockPool_; }
+    [[nodiscard]] inline GenScratch &scratch() { return *scratch_; }
+
+    Settings settings;
+    /* Asked with the star layout of each galaxy, Galaxy::create() returns nullptr
+     * for rejected ones without generating any star */
+    SkeletonFilterFunc skeletonFilter = nullptr;
+    void *skeletonFilterData = nullptr;
+    /* Asked in index order as stars get built, `systemFilter` once the planets of the
+     * star are built too (variants with planets only). Only stars up to the one passed
+     * are built then. Galaxy::create() returns nullptr as soon as one rejects, the rest
+     * of the galaxy is never generated */
+    StarStreamFunc starFilter = nullptr;
+    StarStreamFunc systemFilter = nullptr;
+    void *streamFilterData = nullptr;
+    /* Splits the stars and planet veins of each galaxy over the pool, for the latency
+     * of single galaxies. Galaxies are the same as without it, the ordered parts (names,
+     * planet types) still run in star order on the calling thread. Not used while
+     * stream filters are set, and the pool is only used by one context at a time */
+    util::ThreadPool *pool = nullptr;
+
+private:
+    util::ArenaBlockPool blockPool_;
+    std::unique_ptr<GenScratch> scratch_;
+};
+
+}
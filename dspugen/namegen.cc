@@ -9,127 +9,209 @@
 #include "namegen.hh"
 #include "util/dotnet35random.hh"
 #include <fmt/format.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 
 namespace dspugen {
 
-void strReplace(std::string &subject, const std::string &search,
-                const std::string &replace) {
-    size_t pos = 0;
-    while ((pos = subject.find(search, pos)) != std::string::npos) {
-        subject.replace(pos, search.length(), replace);
-        pos += replace.length();
+/* Replaces in place, `replace` must not be longer than `search`. Returns the new size */
+static size_t strReplace(char *text, size_t size, std::string_view search, std::string_view replace) {
+    size_t in = 0, out = 0;
+    while (in < size) {
+        if (size - in >= search.size() && memcmp(text + in, search.data(), search.size()) == 0) {
+            memcpy(text + out, replace.data(), replace.size());
+            in += search.size();
+            out += replace.size();
+        } else {
+            text[out++] = text[in++];
+        }
     }
+    return out;
 }
 template<typename T, int N>
 char (&dim_helper(T(&)[N]))[N];
 #define dim(x) (sizeof(dim_helper(x)))
 
+/* Star names are written into fixed buffers of StarCold::kNameCapacity bytes,
+ * so that generating them never touches the heap */
+static size_t copyName(char *out, std::string_view str) {
+    auto size = std::min(str.size(), StarCold::kNameCapacity - 1);
+    memcpy(out, str.data(), size);
+    out[size] = 0;
+    return size;
+}
+
+static size_t finishName(char *out, const fmt::format_to_n_result<char *> &res) {
+    auto size = std::min(res.size, StarCold::kNameCapacity - 1);
+    out[size] = 0;
+    return size;
+}
+
+template<typename...T>
+static size_t formatName(char *out, fmt::format_string<T...> format, T &&...args) {
+    return finishName(out, fmt::format_to_n(out, StarCold::kNameCapacity - 1, format, std::forward<T>(args)...));
+}
+
+template<typename...T>
+static size_t formatNameRuntime(char *out, std::string_view format, T &&...args) {
+    return finishName(out, fmt::format_to_n(out, StarCold::kNameCapacity - 1, fmt::runtime(format),
+                                            std::forward<T>(args)...));
+}
+
 std::string NameGen::randomName(int seed) {
-    static const std::string con0[39] = {
+    static constexpr std::string_view con0[39] = {
         "p", "t", "c", "k", "b", "d", "g", "f", "ph", "s",
         "sh", "th", "h", "v", "z", "th", "r", "ch", "tr", "dr",
         "m", "n", "l", "y", "w", "sp", "st", "sk", "sc", "sl",
         "pl", "cl", "bl", "gl", "fr", "fl", "pr", "br", "cr"
     };
 
-    static const std::string con1[16] = {
+    static constexpr std::string_view con1[16] = {
         "thr", "ex", "ec", "el", "er", "ev", "il", "is", "it", "ir",
         "up", "ut", "ur", "un", "gt", "phr"
     };
 
-    static const std::string vow0[7] = {"a", "an", "am", "al", "o", "u", "xe"};
+    static constexpr std::string_view vow0[7] = {"a", "an", "am", "al", "o", "u", "xe"};
 
-    static const std::string vow1[23] = {
+    static constexpr std::string_view vow1[23] = {
         "ea", "ee", "ie", "i", "e", "a", "er", "a", "u", "oo",
         "u", "or", "o", "oa", "ar", "a", "ei", "ai", "i", "au",
         "ou", "ao", "ir"
     };
 
-    static const std::string vow2[7] = {"y", "oi", "io", "iur", "ur", "ac", "ic"};
+    static constexpr std::string_view vow2[7] = {"y", "oi", "io", "iur", "ur", "ac", "ic"};
 
-    static const std::string ending[18] = {
+    static constexpr std::string_view ending[18] = {
         "er", "n", "un", "or", "ar", "o", "o", "ans", "us", "ix",
         "us", "iurs", "a", "eo", "urn", "es", "eon", "y"
     };
 
-    static const std::string roman[21] = {
-        "", "I", "II", "III", "IV", "V", "VI", "VII", "VIII", "IX",
-        "X", "XI", "XII", "XIII", "XIV", "XV", "XVI", "XVII", "XVIII", "XIX",
-        "XX"
+    /* At most 4 syllables of up to 7 characters */
+    char text[32];
+    size_t size = 0;
+    auto append = [&text, &size](std::string_view str) {
+        auto count = std::min(str.size(), sizeof(text) - size);
+        memcpy(text + size, str.data(), count);
+        size += count;
     };
 
     util::DotNet35Random dotNet35Random(seed);
     int num = static_cast<int>(dotNet35Random.nextDouble() * 1.8 + 2.3);
-    std::string text;
     for (int i = 0; i < num; i++) {
         if (dotNet35Random.nextDouble() >= 0.05000000074505806 || i != 0) {
-            text += ((dotNet35Random.nextDouble() >= 0.97000002861022949 && num < 4) ? con1[dotNet35Random.next(dim(con1))] : con0[dotNet35Random.next(dim(con0))]);
-            text += ((i == num - 1 && dotNet35Random.nextDouble() < 0.89999997615814209) ?  ending[dotNet35Random.next(dim(ending))] : (dotNet35Random.nextDouble() >= 0.97000002861022949 ? vow2[dotNet35Random.next(dim(vow2))] : vow1[dotNet35Random.next(dim(vow1))]));
+            append((dotNet35Random.nextDouble() >= 0.97000002861022949 && num < 4) ? con1[dotNet35Random.next(dim(con1))] : con0[dotNet35Random.next(dim(con0))]);
+            append((i == num - 1 && dotNet35Random.nextDouble() < 0.89999997615814209) ?  ending[dotNet35Random.next(dim(ending))] : (dotNet35Random.nextDouble() >= 0.97000002861022949 ? vow2[dotNet35Random.next(dim(vow2))] : vow1[dotNet35Random.next(dim(vow1))]));
         } else {
-            text += vow0[dotNet35Random.next(dim(vow0))];
+            append(vow0[dotNet35Random.next(dim(vow0))]);
         }
     }
 
-    strReplace(text, "uu", "u");
-    strReplace(text, "ooo", "oo");
-    strReplace(text, "eee", "ee");
-    strReplace(text, "eea", "ea");
-    strReplace(text, "aa", "a");
-    strReplace(text, "yy", "y");
-    text[0] = std::toupper(text[0]);
-    return text;
+    size = strReplace(text, size, "uu", "u");
+    size = strReplace(text, size, "ooo", "oo");
+    size = strReplace(text, size, "eee", "ee");
+    size = strReplace(text, size, "eea", "ea");
+    size = strReplace(text, size, "aa", "a");
+    size = strReplace(text, size, "yy", "y");
+    text[0] = static_cast<char>(std::toupper(text[0]));
+    return {text, size};
 }
 
-std::string NameGen::randomStarName(int seed, Star *starData, Galaxy *galaxy) {
+void NameGen::randomStarName(int seed, Star *starData, Galaxy *galaxy) {
     util::DotNet35Random dotNet35Random(seed);
+    char text[StarCold::kNameCapacity];
+    auto *cold = starData->cold;
     int num = 0;
     while (num++ < 256) {
-        std::string text = _randomStarName(dotNet35Random.next(), starData);
-        bool flag = false;
-        for (int i = 0; i < galaxy->starCount; i++) {
-            if (galaxy->stars[i] != nullptr && galaxy->stars[i]->name == text) {
-                flag = true;
-                break;
-            }
-        }
-        if (!flag) {
-            return text;
+        auto size = _randomStarName(dotNet35Random.next(), starData, text);
+        std::string_view name(text, size);
+        auto **slot = nameSlot(name, galaxy);
+        if (*slot == nullptr) {
+            cold->nameLength = static_cast<uint8_t>(copyName(cold->name, name));
+            *slot = starData;
+            return;
         }
     }
-    return "XStar";
+    cold->nameLength = static_cast<uint8_t>(copyName(cold->name, "XStar"));
+    auto **slot = nameSlot(starData->name(), galaxy);
+    if (*slot == nullptr) *slot = starData;
+}
+
+void NameGen::firstStarName(int seed, Star *starData) {
+    util::DotNet35Random dotNet35Random(seed);
+    auto *cold = starData->cold;
+    _randomStarName(dotNet35Random.next(), starData, cold->name);
+    cold->nameLength = 0;
+}
+
+void NameGen::settleStarName(int seed, Star *starData, Galaxy *galaxy) {
+    auto *cold = starData->cold;
+    std::string_view name(cold->name, strlen(cold->name));
+    auto **slot = nameSlot(name, galaxy);
+    if (*slot != nullptr) {
+        randomStarName(seed, starData, galaxy);
+        return;
+    }
+    cold->nameLength = static_cast<uint8_t>(name.size());
+    *slot = starData;
+}
+
+/* FNV-1a */
+static uint32_t nameHash(std::string_view name) {
+    uint32_t hash = 2166136261u;
+    for (auto c: name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+Star **NameGen::nameSlot(std::string_view name, Galaxy *galaxy) {
+    auto &slots = galaxy->nameSlots;
+    if (slots.empty()) {
+        /* At most half full with every star named */
+        size_t capacity = 16;
+        while (capacity < galaxy->stars.size() * 2) capacity <<= 1;
+        slots.resize(galaxy->arena, capacity);
+    }
+    auto mask = slots.size() - 1;
+    for (auto i = nameHash(name) & mask;; i = (i + 1) & mask) {
+        auto *&slot = slots[i];
+        if (slot == nullptr || slot->name() == name) return &slot;
+    }
 }
 
-std::string NameGen::_randomStarName(int seed, Star *starData) {
+size_t NameGen::_randomStarName(int seed, Star *starData, char *out) {
     util::DotNet35Random dotNet35Random(seed);
     int seed2 = dotNet35Random.next();
     double num = dotNet35Random.nextDouble();
     double num2 = dotNet35Random.nextDouble();
     if (starData->type == EStarType::GiantStar) {
         if (num2 < 0.40000000596046448) {
-            return randomGiantStarNameFromRawNames(seed2);
+            return randomGiantStarNameFromRawNames(seed2, out);
         }
         if (num2 < 0.699999988079071) {
-            return randomGiantStarNameWithConstellationAlpha(seed2);
+            return randomGiantStarNameWithConstellationAlpha(seed2, out);
         }
-        return randomGiantStarNameWithFormat(seed2);
+        return randomGiantStarNameWithFormat(seed2, out);
     }
     if (starData->type == EStarType::NeutronStar) {
-        return randomNeutronStarNameWithFormat(seed2);
+        return randomNeutronStarNameWithFormat(seed2, out);
     }
     if (starData->type == EStarType::BlackHole) {
-        return randomBlackHoleNameWithFormat(seed2);
+        return randomBlackHoleNameWithFormat(seed2, out);
     }
     if (num < 0.60000002384185791) {
-        return randomStarNameFromRawNames(seed2);
+        return randomStarNameFromRawNames(seed2, out);
     }
     if (num < 0.93000000715255737) {
-        return randomStarNameWithConstellationAlpha(seed2);
+        return randomStarNameWithConstellationAlpha(seed2, out);
     }
-    return randomStarNameWithConstellationNumber(seed2);
+    return randomStarNameWithConstellationNumber(seed2, out);
 }
 
-std::string NameGen::randomStarNameFromRawNames(int seed) {
-    static const std::string raw_star_names[425] = {
+size_t NameGen::randomStarNameFromRawNames(int seed, char *out) {
+    static constexpr std::string_view raw_star_names[425] = {
         "Acamar", "Achernar", "Achird", "Acrab", "Acrux", "Acubens", "Adhafera", "Adhara", "Adhil", "Agena",
         "Aladfar", "Albaldah", "Albali", "Albireo", "Alchiba", "Alcor", "Alcyone", "Alderamin", "Aldhibain", "Aldib",
         "Alfecca", "Alfirk", "Algedi", "Algenib", "Algenubi", "Algieba", "Algjebbath", "Algol", "Algomeyla", "Algorab",
@@ -194,11 +276,11 @@ std::string NameGen::randomStarNameFromRawNames(int seed) {
     util::DotNet35Random dotNet35Random(seed);
     int num = dotNet35Random.next();
     num %= dim(raw_star_names);
-    return raw_star_names[num];
+    return copyName(out, raw_star_names[num]);
 }
 
-inline const std::string &constellations(int num) {
-    static const std::string str[88] = {
+static std::string_view constellations(int num) {
+    static constexpr std::string_view str[88] = {
         "Andromedae", "Antliae", "Apodis", "Aquarii", "Aquilae", "Arae", "Arietis", "Aurigae", "Bootis", "Caeli",
         "Camelopardalis", "Cancri", "Canum Venaticorum", "Canis Majoris", "Canis Minoris", "Capricorni", "Carinae",
         "Cassiopeiae", "Centauri", "Cephei",
@@ -218,13 +300,13 @@ inline const std::string &constellations(int num) {
     return str[num % dim(str)];
 }
 
-std::string NameGen::randomStarNameWithConstellationAlpha(int seed) {
-    static const std::string alphabeta[11] = {
+size_t NameGen::randomStarNameWithConstellationAlpha(int seed, char *out) {
+    static constexpr std::string_view alphabeta[11] = {
         "Alpha", "Beta", "Gamma", "Delta", "Epsilon", "Zeta", "Eta", "Theta", "Iota", "Kappa",
         "Lambda"
     };
 
-    static const std::string alphabeta_letter[11] = {
+    static constexpr std::string_view alphabeta_letter[11] = {
         "α", "β", "γ", "δ", "ε", "ζ", "η", "θ", "ι", "κ",
         "λ"
     };
@@ -233,22 +315,22 @@ std::string NameGen::randomStarNameWithConstellationAlpha(int seed) {
     int num = dotNet35Random.next();
     int num2 = dotNet35Random.next();
     num2 %= dim(alphabeta);
-    std::string text = constellations(num);
+    const auto &text = constellations(num);
     if (text.length() > 10) {
-        return alphabeta_letter[num2] + " " + text;
+        return formatName(out, "{} {}", alphabeta_letter[num2], text);
     }
-    return alphabeta[num2] + " " + text;
+    return formatName(out, "{} {}", alphabeta[num2], text);
 }
 
-std::string NameGen::randomStarNameWithConstellationNumber(int seed) {
+size_t NameGen::randomStarNameWithConstellationNumber(int seed, char *out) {
     util::DotNet35Random dotNet35Random(seed);
     int num = dotNet35Random.next();
     int num2 = dotNet35Random.next(27, 75);
-    return std::to_string(num2) + ' ' + constellations(num);
+    return formatName(out, "{} {}", num2, constellations(num));
 }
 
-std::string NameGen::randomGiantStarNameFromRawNames(int seed) {
-    static const std::string raw_giant_names[60] = {
+size_t NameGen::randomGiantStarNameFromRawNames(int seed, char *out) {
+    static constexpr std::string_view raw_giant_names[60] = {
         "AH Scorpii", "Aldebaran", "Alpha Herculis", "Antares", "Arcturus", "AV Persei", "BC Cygni", "Betelgeuse",
         "BI Cygni", "BO Carinae",
         "Canopus", "CE Tauri", "CK Carinae", "CW Leonis", "Deneb", "Epsilon Aurigae", "Eta Carinae", "EV Carinae",
@@ -266,32 +348,32 @@ std::string NameGen::randomGiantStarNameFromRawNames(int seed) {
     util::DotNet35Random dotNet35Random(seed);
     int num = dotNet35Random.next();
     num %= dim(raw_giant_names);
-    return raw_giant_names[num];
+    return copyName(out, raw_giant_names[num]);
 }
 
-std::string NameGen::randomGiantStarNameWithConstellationAlpha(int seed) {
+size_t NameGen::randomGiantStarNameWithConstellationAlpha(int seed, char *out) {
     util::DotNet35Random dotNet35Random(seed);
     int num = dotNet35Random.next();
     int num2 = dotNet35Random.next(15, 26);
     int num3 = dotNet35Random.next(0, 26);
     int num4 = (65 + num2);
     int num5 = (65 + num3);
-    return std::to_string(num4 + num5) + ' ' + constellations(num);
+    return formatName(out, "{} {}", num4 + num5, constellations(num));
 }
 
-std::string NameGen::randomGiantStarNameWithFormat(int seed) {
-    static const std::string giant_name_formats[7] = {"HD {0:04}{1:02}", "HDE {0:04}{1:02}", "HR {0:04}", "HV {0:04}", "LBV {0:04}-{1:02}", "NSV {0:04}", "YSC {0:04}-{1:02}"};
+size_t NameGen::randomGiantStarNameWithFormat(int seed, char *out) {
+    static constexpr std::string_view giant_name_formats[7] = {"HD {0:04}{1:02}", "HDE {0:04}{1:02}", "HR {0:04}", "HV {0:04}", "LBV {0:04}-{1:02}", "NSV {0:04}", "YSC {0:04}-{1:02}"};
 
     util::DotNet35Random dotNet35Random(seed);
     int num = dotNet35Random.next();
     int num2 = dotNet35Random.next(10000);
     int num3 = dotNet35Random.next(100);
     num %= dim(giant_name_formats);
-    return fmt::format(giant_name_formats[num], num2, num3);
+    return formatNameRuntime(out, giant_name_formats[num], num2, num3);
 }
 
-std::string NameGen::randomNeutronStarNameWithFormat(int seed) {
-    static const std::string neutron_star_name_formats[2] = {"NTR J{0:02}{1:02}+{2:02}", "NTR J{0:02}{1:02}-{2:02}"};
+size_t NameGen::randomNeutronStarNameWithFormat(int seed, char *out) {
+    static constexpr std::string_view neutron_star_name_formats[2] = {"NTR J{0:02}{1:02}+{2:02}", "NTR J{0:02}{1:02}-{2:02}"};
 
     util::DotNet35Random dotNet35Random(seed);
     int num = dotNet35Random.next();
@@ -299,11 +381,11 @@ std::string NameGen::randomNeutronStarNameWithFormat(int seed) {
     int num3 = dotNet35Random.next(60);
     int num4 = dotNet35Random.next(0, 60);
     num %= dim(neutron_star_name_formats);
-    return fmt::format(neutron_star_name_formats[num], num2, num3, num4);
+    return formatNameRuntime(out, neutron_star_name_formats[num], num2, num3, num4);
 }
 
-std::string NameGen::randomBlackHoleNameWithFormat(int seed) {
-    static const std::string black_hole_name_formats[2] = {"DSR J{0:02}{1:02}+{2:02}", "DSR J{0:02}{1:02}-{2:02}"};
+size_t NameGen::randomBlackHoleNameWithFormat(int seed, char *out) {
+    static constexpr std::string_view black_hole_name_formats[2] = {"DSR J{0:02}{1:02}+{2:02}", "DSR J{0:02}{1:02}-{2:02}"};
 
     util::DotNet35Random dotNet35Random(seed);
     int num = dotNet35Random.next();
@@ -311,7 +393,7 @@ std::string NameGen::randomBlackHoleNameWithFormat(int seed) {
     int num3 = dotNet35Random.next(60);
     int num4 = dotNet35Random.next(0, 60);
     num %= dim(black_hole_name_formats);
-    return fmt::format(black_hole_name_formats[num], num2, num3, num4);
+    return formatNameRuntime(out, black_hole_name_formats[num], num2, num3, num4);
 }
 
 }
@@ -11,6 +11,7 @@
 #include "star.hh"
 #include "galaxy.hh"
 #include <string>
+#include <string_view>
 #include <cstdint>
 
 namespace dspugen {
@@ -19,18 +20,30 @@ class NameGen {
 public:
     static std::string randomName(int seed);
 
-    static std::string randomStarName(int seed, Star *starData, Galaxy *galaxy);
+    /* Writes a name not taken by other stars of `galaxy` into `starData` */
+    static void randomStarName(int seed, Star *starData, Galaxy *galaxy);
+    /* randomStarName() split in two for stars built in parallel: the first name it tries
+     * only depends on the star, it is left in the name buffer of `starData` without being
+     * taken. settleStarName() then takes it if no other star has it, or rolls again like
+     * randomStarName(). Settling has to go in star order */
+    static void firstStarName(int seed, Star *starData);
+    static void settleStarName(int seed, Star *starData, Galaxy *galaxy);
 
 private:
-    static std::string _randomStarName(int seed, Star *starData);
-    static std::string randomStarNameFromRawNames(int seed);
-    static std::string randomStarNameWithConstellationAlpha(int seed);
-    static std::string randomStarNameWithConstellationNumber(int seed);
-    static std::string randomGiantStarNameFromRawNames(int seed);
-    static std::string randomGiantStarNameWithConstellationAlpha(int seed);
-    static std::string randomGiantStarNameWithFormat(int seed);
-    static std::string randomNeutronStarNameWithFormat(int seed);
-    static std::string randomBlackHoleNameWithFormat(int seed);
+    /* Slot of the star named `name` in `galaxy->nameSlots`, or the empty slot where
+     * a star taking that name goes */
+    static Star **nameSlot(std::string_view name, Galaxy *galaxy);
+    /* These write at most StarCold::kNameCapacity bytes into `out`, NUL included,
+     * and return the name length */
+    static size_t _randomStarName(int seed, Star *starData, char *out);
+    static size_t randomStarNameFromRawNames(int seed, char *out);
+    static size_t randomStarNameWithConstellationAlpha(int seed, char *out);
+    static size_t randomStarNameWithConstellationNumber(int seed, char *out);
+    static size_t randomGiantStarNameFromRawNames(int seed, char *out);
+    static size_t randomGiantStarNameWithConstellationAlpha(int seed, char *out);
+    static size_t randomGiantStarNameWithFormat(int seed, char *out);
+    static size_t randomNeutronStarNameWithFormat(int seed, char *out);
+    static size_t randomBlackHoleNameWithFormat(int seed, char *out);
 };
 
 }
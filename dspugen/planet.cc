@@ -13,58 +13,54 @@
 #include "protoset.hh"
 #include "util/dotnet35random.hh"
 #include "util/maths.hh"
-#include "util/mempool.hh"
 
 #include <algorithm>
 
 namespace dspugen {
 
-static thread_local util::MemPool<Planet> *ppool;
+static_assert(std::is_trivially_destructible_v<Planet>, "planets are dropped with their galaxy arena");
 
 static constexpr float OrbitRadiusFactor[17] = {
     0.0f, 0.4f, 0.7f, 1.0f, 1.4f, 1.9f, 2.5f, 3.3f, 4.3f, 5.5f,
     6.9f, 8.4f, 10.0f, 11.7f, 13.5f, 15.4f, 17.5f
 };
 
-void Planet::initThread() {
-    ppool = new util::MemPool<Planet>();
-}
-
-void Planet::releaseThread() {
-    delete ppool;
-}
-
-void Planet::release() {
-    ppool->release(this);
-}
+/* Draws only tested against thresholds are compared as raw samples, see
+ * DotNet35Random::nextRaw(). Singularities by the 14th draw of a planet */
+static constexpr int RawLaySide = util::DotNet35Random::rawAtLeast(0.039999999105930328);
+static constexpr int RawClockwiseFrom = util::DotNet35Random::rawAbove(0.85);
+static constexpr int RawTidalLocked4 = util::DotNet35Random::rawAbove(0.89999997615814209);
+static constexpr int RawClockwiseTo = util::DotNet35Random::rawAbove(0.9);
+static constexpr int RawTidalLocked2 = util::DotNet35Random::rawAbove(0.93000000715255737);
+static constexpr int RawTidalLocked = util::DotNet35Random::rawAbove(0.95999997854232788);
+/* Chances of one more vein spot around white dwarfs, neutron stars and black holes */
+static constexpr int RawMoreVein045 = util::DotNet35Random::rawAtLeast(0.44999998807907104);
+static constexpr int RawMoreVein05 = util::DotNet35Random::rawAtLeast(0.5);
+static constexpr int RawMoreVein065 = util::DotNet35Random::rawAtLeast(0.64999997615814209);
 
 Planet *Planet::create(Star *star, int index, int orbitAround, int orbitIndex, int number,
                        bool gasGiant, int infoSeed, int genSeed) {
-    auto planet = ppool->alloc();
+    auto *planet = star->cold->planets[index];
     util::DotNet35Random dotNet35Random(infoSeed);
     auto *galaxy = star->galaxy;
-    planet->index = index;
-    planet->galaxy = galaxy;
+    planet->cold->index = index;
+    planet->cold->galaxy = galaxy;
     planet->star = star;
-    planet->seed = genSeed;
+    planet->cold->seed = genSeed;
 /*
     planet->infoSeed = infoSeed;
 */
     planet->orbitAround = orbitAround;
-    planet->orbitIndex = orbitIndex;
-    planet->number = number;
+    planet->cold->orbitIndex = orbitIndex;
+    planet->cold->number = number;
     planet->id = star->id * 100 + index + 1;
-    auto &stars = galaxy->stars;
-    auto num = 0;
-    for (auto i = 0; i < star->index; i++) num += static_cast<int>(stars[i]->planets.size());
-    num += index;
     if (orbitAround > 0) {
-        auto planetCount = static_cast<int>(star->planets.size());
+        auto planetCount = static_cast<int>(star->cold->planets.size());
         for (auto j = 0; j < planetCount; j++)
-            if (orbitAround == star->planets[j]->number && star->planets[j]->orbitAround == 0) {
-                planet->orbitAroundPlanet = star->planets[j];
+            if (orbitAround == star->cold->planets[j]->cold->number && star->cold->planets[j]->orbitAround == 0) {
+                planet->cold->orbitAroundPlanet = star->cold->planets[j];
                 if (orbitIndex > 1)
-                    planet->orbitAroundPlanet->singularity |= EPlanetSingularity::MultipleSatellites;
+                    planet->cold->orbitAroundPlanet->singularity |= EPlanetSingularity::MultipleSatellites;
                 break;
             }
     }
@@ -81,7 +77,7 @@ Planet *Planet::create(Star *star, int index, int orbitAround, int orbitIndex, i
     auto num12 = dotNet35Random.nextDouble();
     auto num13 = dotNet35Random.nextDouble();
     auto rand = dotNet35Random.nextDouble();
-    auto num14 = dotNet35Random.nextDouble();
+    auto num14 = dotNet35Random.nextRaw();
     auto rand2 = dotNet35Random.nextDouble();
     auto rand3 = dotNet35Random.nextDouble();
     auto rand4 = dotNet35Random.nextDouble();
@@ -89,12 +85,12 @@ Planet *Planet::create(Star *star, int index, int orbitAround, int orbitIndex, i
     auto num15 = std::pow(1.2f, float(num2 * (num3 - 0.5) * 0.5));
     float num16;
     if (orbitAround == 0) {
-        num16 = OrbitRadiusFactor[orbitIndex] * star->orbitScaler;
+        num16 = OrbitRadiusFactor[orbitIndex] * star->cold->orbitScaler;
         auto num17 = (num15 - 1.0f) / std::max(1.0f, num16) + 1.0f;
         num16 *= num17;
     } else {
-        num16 = ((1600.0f * orbitIndex + 200.0f) * std::pow(star->orbitScaler, 0.3f) *
-                 util::lerp(num15, 1.0f, 0.5f) + planet->orbitAroundPlanet->realRadius()) / 40000.0;
+        num16 = ((1600.0f * orbitIndex + 200.0f) * std::pow(star->cold->orbitScaler, 0.3f) *
+                 util::lerp(num15, 1.0f, 0.5f) + planet->cold->orbitAroundPlanet->realRadius()) / 40000.0;
     }
 
     planet->orbitRadius = num16;
@@ -110,12 +106,12 @@ Planet *Planet::create(Star *star, int index, int orbitAround, int orbitIndex, i
     }
 
     planet->orbitalPeriod =
-        std::sqrt(39.478417604357432 * num16 * num16 * num16 / (planet->orbitAroundPlanet == nullptr
-                                                                ? 1.3538551990520382E-06 * star->mass
+        std::sqrt(39.478417604357432 * num16 * num16 * num16 / (planet->cold->orbitAroundPlanet == nullptr
+                                                                ? 1.3538551990520382E-06 * star->cold->mass
                                                                 : 1.0830842106853677E-08));
     planet->orbitPhase = float(num6 * 360.0);
 */
-    if (num14 < 0.039999999105930328) {
+    if (num14 < RawLaySide) {
 /*
         planet->obliquity = float(num7 * (num8 - 0.5) * 39.9);
         if (planet->obliquity < 0.0f)
@@ -150,27 +146,27 @@ Planet *Planet::create(Star *star, int index, int orbitAround, int orbitIndex, i
 
     planet->rotationPhase = float(num11 * 360.0);
 */
-    planet->sunDistance =
-        orbitAround == 0 ? planet->orbitRadius : planet->orbitAroundPlanet->orbitRadius;
-    planet->scale = 1.0f;
+    planet->cold->sunDistance =
+        orbitAround == 0 ? planet->orbitRadius : planet->cold->orbitAroundPlanet->orbitRadius;
+    planet->cold->scale = 1.0f;
 /*
-    auto num18 = orbitAround == 0 ? planet->orbitalPeriod : planet->orbitAroundPlanet->orbitalPeriod;
+    auto num18 = orbitAround == 0 ? planet->orbitalPeriod : planet->cold->orbitAroundPlanet->orbitalPeriod;
     planet->rotationPeriod = 1.0 / (1.0 / num18 + 1.0 / planet->rotationPeriod);
 */
     if (orbitAround == 0 && orbitIndex <= 4 && !gasGiant) {
-        if (num14 > 0.95999997854232788) {
+        if (num14 >= RawTidalLocked) {
 /*
             planet->obliquity *= 0.01f;
             planet->rotationPeriod = planet->orbitalPeriod;
 */
             planet->singularity |= EPlanetSingularity::TidalLocked;
-        } else if (num14 > 0.93000000715255737) {
+        } else if (num14 >= RawTidalLocked2) {
 /*
             planet->obliquity *= 0.1f;
             planet->rotationPeriod = planet->orbitalPeriod * 0.5;
 */
             planet->singularity |= EPlanetSingularity::TidalLocked2;
-        } else if (num14 > 0.89999997615814209) {
+        } else if (num14 >= RawTidalLocked4) {
 /*
             planet->obliquity *= 0.2f;
             planet->rotationPeriod = planet->orbitalPeriod * 0.25;
@@ -179,25 +175,25 @@ Planet *Planet::create(Star *star, int index, int orbitAround, int orbitIndex, i
         }
     }
 
-    if (num14 > 0.85 && num14 <= 0.9) {
+    if (num14 >= RawClockwiseFrom && num14 < RawClockwiseTo) {
 /*
         planet->rotationPeriod = 0.0 - planet->rotationPeriod;
 */
         planet->singularity |= EPlanetSingularity::ClockwiseRotate;
     }
 
-    auto habitableRadius = star->habitableRadius;
+    auto habitableRadius = star->cold->habitableRadius;
     if (gasGiant) {
         planet->type = EPlanetType::Gas;
-        planet->radius = 80.0f;
-        planet->scale = 10.0f;
-        planet->habitableBias = 100.0f;
+        planet->cold->radius = 80.0f;
+        planet->cold->scale = 10.0f;
+        planet->cold->habitableBias = 100.0f;
     } else {
         auto num19 = std::ceil(galaxy->starCount * 0.29f);
         if (num19 < 11.0f) num19 = 11.0f;
         auto num20 = num19 - static_cast<float>(galaxy->HabitableCount);
         auto num21 = static_cast<float>(galaxy->starCount - star->index);
-        auto sunDistance = planet->sunDistance;
+        auto sunDistance = planet->cold->sunDistance;
         auto num22 = 1000.0f;
         auto num23 = 1000.0f;
         if (habitableRadius > 0.0f && sunDistance > 0.0f) {
@@ -209,14 +205,14 @@ Planet *Planet::create(Star *star, int index, int orbitAround, int orbitIndex, i
         auto a = num20 / num21;
         a = util::lerp(a, 0.35f, 0.5f);
         a = std::clamp(a, 0.08f, 0.8f);
-        planet->habitableBias = num22 * num24;
-        planet->temperatureBias = 1.2f / (num23 + 0.2f) - 1.0f;
+        planet->cold->habitableBias = num22 * num24;
+        planet->cold->temperatureBias = 1.2f / (num23 + 0.2f) - 1.0f;
 
-        auto f = util::clamp01(planet->habitableBias / a);
+        auto f = util::clamp01(planet->cold->habitableBias / a);
         auto p = a * 10.0f;
         f = std::pow(f, p);
         if (num12 > f && star->index > 0 ||
-            planet->orbitAround > 0 && planet->orbitIndex == 1 && star->index == 0) {
+            planet->orbitAround > 0 && planet->cold->orbitIndex == 1 && star->index == 0) {
             planet->type = EPlanetType::Ocean;
             galaxy->HabitableCount++;
         } else if (num23 < 0.833333f) {
@@ -229,7 +225,7 @@ Planet *Planet::create(Star *star, int index, int orbitAround, int orbitIndex, i
             planet->type = num13 < num26 ? EPlanetType::Desert : EPlanetType::Ice;
         }
 
-        planet->radius = 200.0f;
+        planet->cold->radius = 200.0f;
     }
 
 /*
@@ -242,25 +238,26 @@ Planet *Planet::create(Star *star, int index, int orbitAround, int orbitIndex, i
     }
 */
 
-    planet->luminosity = std::pow(planet->star->lightBalanceRadius / (planet->sunDistance + 0.01f), 0.6f);
-    if (planet->luminosity > 1.0f) {
-        planet->luminosity = std::log(planet->luminosity) + 1.0f;
-        planet->luminosity = std::log(planet->luminosity) + 1.0f;
-        planet->luminosity = std::log(planet->luminosity) + 1.0f;
+    planet->cold->luminosity = std::pow(planet->star->cold->lightBalanceRadius / (planet->cold->sunDistance + 0.01f), 0.6f);
+    if (planet->cold->luminosity > 1.0f) {
+        planet->cold->luminosity = std::log(planet->cold->luminosity) + 1.0f;
+        planet->cold->luminosity = std::log(planet->cold->luminosity) + 1.0f;
+        planet->cold->luminosity = std::log(planet->cold->luminosity) + 1.0f;
     }
 
-    planet->luminosity = std::round(planet->luminosity * 100.0f) / 100.0f;
+    planet->cold->luminosity = std::round(planet->cold->luminosity * 100.0f) / 100.0f;
     planet->setPlanetTheme(rand, rand2, rand3, rand4, themeSeed);
-    planet->generateVeins();
+    if (!galaxy->noVeins) planet->generateVeins();
     return planet;
 }
 
 void Planet::generateGas() {
-    if (type != EPlanetType::Gas || !gasItems.empty()) return;
-    const auto *themeProto4 = themeProtoSet.select(theme);
-    auto num3 = static_cast<int>(themeProto4->gasSpeeds.size());
-    gasItems = themeProto4->gasItems;
-    gasSpeeds.resize(num3);
+    if (type != EPlanetType::Gas || !cold->gasItems.empty()) return;
+    const auto *themeProto4 = themeHotTable.select(theme);
+    auto num3 = static_cast<int>(themeProto4->gasSpeedCount);
+    const auto *gasSpeeds = themeHotTable.gasSpeeds(*themeProto4);
+    cold->gasItems.assign(cold->galaxy->arena, themeHotTable.gasItems(*themeProto4), themeProto4->gasItemCount);
+    cold->gasSpeeds.resize(cold->galaxy->arena, num3);
 /*
     gasHeatValues.resize(num2);
 */
@@ -268,13 +265,13 @@ void Planet::generateGas() {
 /*
     auto num4 = 0.0;
 */
-    util::DotNet35Random dotNet35Random(themeSeed);
+    util::DotNet35Random dotNet35Random(cold->themeSeed);
     for (auto num5 = 0; num5 < num3; num5++) {
-        gasSpeeds[num5] = themeProto4->gasSpeeds[num5] * (dotNet35Random.nextDouble() * 0.190909147f + 0.9090909f) * std::pow(resourceCoef, 0.3f);
+        cold->gasSpeeds[num5] = gasSpeeds[num5] * (dotNet35Random.nextDouble() * 0.190909147f + 0.9090909f) * std::pow(resourceCoef, 0.3f);
 /*
-        auto *itemProto = itemProtoSet.select(gasItems[num5]);
+        auto *itemProto = itemProtoSet.select(cold->gasItems[num5]);
         gasHeatValues[num5] = itemProto->heatValue;
-        num4 += gasHeatValues[num5] * gasSpeeds[num5];
+        num4 += gasHeatValues[num5] * cold->gasSpeeds[num5];
 */
     }
 
@@ -284,63 +281,56 @@ void Planet::generateGas() {
 }
 
 void Planet::setPlanetTheme(double rand1, double rand2, double rand3, double rand4, int thmSeed) {
-    int tmpTheme[32];
-    int tmpThemeCount = 0;
-    this->themeSeed = thmSeed;
-    for (const auto &themeProto: themeProtoSet.dataArray) {
-        auto flag = false;
-        if (star->index == 0 && type == EPlanetType::Ocean) {
-            if (themeProto.distribute == EThemeDistribute::Birth) flag = true;
-        } else {
-            bool flag2 = themeProto.temperature * temperatureBias >= -0.1f;
-            if (std::abs(themeProto.temperature) < 0.5f && themeProto.planetType == static_cast<int>(EPlanetType::Desert)) {
-                flag2 = std::abs(temperatureBias) < std::abs(themeProto.temperature) + 0.1f;
-            }
-            if (themeProto.planetType == static_cast<int>(type) && flag2) {
-                if (star->index == 0) {
-                    if (themeProto.distribute == EThemeDistribute::Default) {
-                        flag = true;
-                    }
-                } else if (themeProto.distribute == EThemeDistribute::Default || themeProto.distribute == EThemeDistribute::Interstellar) {
-                    flag = true;
-                }
-            }
+    cold->themeSeed = thmSeed;
+    const auto &themes = themeHotTable.themes();
+    auto birthStar = star->index == 0;
+    if (themeHotTable.hasMasks()) {
+        uint32_t used = 0;
+        for (auto j = 0; j < cold->index; j++) used |= themeHotTable.idMask(star->cold->planets[j]->theme);
+        auto mask = themeHotTable.candidateMask(static_cast<int>(type), birthStar, cold->temperatureBias) & ~used;
+        if (mask == 0) {
+            auto desert = themeHotTable.desertMask();
+            mask = (desert & ~used) != 0 ? desert & ~used : desert;
         }
-
-        if (flag)
-            for (auto j = 0; j < index; j++)
-                if (star->planets[j]->theme == themeProto.id) {
-                    flag = false;
+        auto count = util::bitCount(mask);
+        theme = themes[util::nthBitIndex(mask, static_cast<int>(rand1 * count) % count)].id;
+    } else {
+        /* Too many themes for the masks: count the themes of a list, then walk it again
+         * to the picked one, so nothing is stored per planet */
+        auto used = [this](int id) {
+            for (auto j = 0; j < cold->index; j++)
+                if (star->cold->planets[j]->theme == id) return true;
+            return false;
+        };
+        auto pickTheme = [this, &themes, rand1](auto &&inList) {
+            auto tmpThemeCount = 0;
+            for (const auto &themeProto: themes)
+                if (inList(themeProto)) tmpThemeCount++;
+            if (tmpThemeCount == 0) return false;
+            auto pick = static_cast<int>(rand1 * tmpThemeCount) % tmpThemeCount;
+            for (const auto &themeProto: themes)
+                if (inList(themeProto) && pick-- == 0) {
+                    theme = themeProto.id;
                     break;
                 }
-
-        if (flag) tmpTheme[tmpThemeCount++] = themeProto.id;
-    }
-
-    if (tmpThemeCount == 0)
-        for (const auto &themeProto2: themeProtoSet.dataArray) {
-            auto flag2 = themeProto2.planetType == static_cast<int>(EPlanetType::Desert);
-            if (flag2)
-                for (auto l = 0; l < index; l++)
-                    if (star->planets[l]->theme == themeProto2.id) {
-                        flag2 = false;
-                        break;
-                    }
-
-            if (flag2) tmpTheme[tmpThemeCount++] = themeProto2.id;
-        }
-
-    if (tmpThemeCount == 0)
-        for (const auto &themeProto3: themeProtoSet.dataArray) {
-            if (themeProto3.planetType == static_cast<int>(EPlanetType::Desert)) tmpTheme[tmpThemeCount++] = themeProto3.id;
+            return true;
+        };
+        auto desert = [](const ThemeHot &themeProto) {
+            return themeProto.planetType == static_cast<int>(EPlanetType::Desert);
+        };
+        if (!pickTheme([&](const ThemeHot &themeProto) {
+                return ThemeHotTable::fits(themeProto, static_cast<int>(type), birthStar, cold->temperatureBias) && !used(themeProto.id);
+            }) &&
+            !pickTheme([&](const ThemeHot &themeProto) { return desert(themeProto) && !used(themeProto.id); })) {
+            pickTheme(desert);
         }
+    }
 
-    theme = tmpTheme[static_cast<int>(rand1 * tmpThemeCount) % tmpThemeCount];
-    const auto *themeProto4 = themeProtoSet.select(theme);
-    algoId = 0;
-    if (themeProto4 != nullptr && !themeProto4->algos.empty()) {
-        auto count = static_cast<int>(themeProto4->algos.size());
-        algoId = themeProto4->algos[static_cast<int>(rand2 * count) % count];
+    const auto *themeProto4 = themeHotTable.select(theme);
+    cold->algoId = 0;
+    if (themeProto4 != nullptr && themeProto4->algoCount > 0) {
+        auto count = static_cast<int>(themeProto4->algoCount);
+        cold->algoId = themeHotTable.algos(*themeProto4)[static_cast<int>(rand2 * count) % count];
 /*
         modX = themeProto4->modX.x + rand3 * (themeProto4->modX.y - themeProto4->modX.x);
         modY = themeProto4->modY.x + rand4 * (themeProto4->modY.y - themeProto4->modY.x);
@@ -350,7 +340,7 @@ void Planet::setPlanetTheme(double rand1, double rand2, double rand3, double ran
     if (themeProto4 == nullptr) return;
     type = static_cast<EPlanetType>(themeProto4->planetType);
 /*
-    style = themeSeed % 60;
+    style = cold->themeSeed % 60;
     ionHeight = themeProto4->ionHeight;
     windStrength = themeProto4->wind;
     waterHeight = themeProto4->waterHeight;
@@ -361,10 +351,10 @@ void Planet::setPlanetTheme(double rand1, double rand2, double rand3, double ran
 }
 
 void Planet::generateVeins() {
-    if (algoId >= 1 && algoId <= 13) {
-        const auto *themeProto = themeProtoSet.select(theme);
+    if (cold->algoId >= 1 && cold->algoId <= 13) {
+        const auto *themeProto = themeHotTable.select(theme);
         if (themeProto == nullptr) return;
-        util::DotNet35Random dotNet35Random(seed);
+        util::DotNet35Random dotNet35Random(cold->seed);
         dotNet35Random.next();
         dotNet35Random.next();
         dotNet35Random.next();
@@ -374,8 +364,8 @@ void Planet::generateVeins() {
         dotNet35Random.next();
         // => util::DotNet35Random dotNet35Random2(dotNet35Random.next());
 
-        // auto num = 2.1f / radius;
-        memcpy(&veinSpot[1], &themeProto->veinSpot[0], sizeof(int) * std::min(14, static_cast<int>(themeProto->veinSpot.size())));
+        // auto num = 2.1f / cold->radius;
+        memcpy(&veinSpot[1], themeHotTable.veinSpot(*themeProto), sizeof(int) * std::min(14, static_cast<int>(themeProto->veinSpotCount)));
         auto p = 1.0f;
         auto spectr = star->spectr;
         switch (star->type) {
@@ -414,19 +404,19 @@ void Planet::generateVeins() {
                 p = 3.5f;
                 veinSpot[9] += 2;
                 for (auto j = 1; j < 12; j++) {
-                    if (dotNet35Random.nextDouble() >= 0.44999998807907104) break;
+                    if (dotNet35Random.nextRaw() >= RawMoreVein045) break;
                     veinSpot[9]++;
                 }
 
                 veinSpot[10] += 2;
                 for (auto k = 1; k < 12; k++) {
-                    if (dotNet35Random.nextDouble() >= 0.44999998807907104) break;
+                    if (dotNet35Random.nextRaw() >= RawMoreVein045) break;
                     veinSpot[10]++;
                 }
 
                 veinSpot[12]++;
                 for (auto l = 1; l < 12; l++) {
-                    if (dotNet35Random.nextDouble() >= 0.5) break;
+                    if (dotNet35Random.nextRaw() >= RawMoreVein05) break;
                     veinSpot[12]++;
                 }
 
@@ -436,7 +426,7 @@ void Planet::generateVeins() {
                 p = 4.5f;
                 veinSpot[14]++;
                 for (auto m = 1; m < 12; m++) {
-                    if (dotNet35Random.nextDouble() >= 0.64999997615814209) break;
+                    if (dotNet35Random.nextRaw() >= RawMoreVein065) break;
                     veinSpot[14]++;
                 }
                 break;
@@ -445,23 +435,24 @@ void Planet::generateVeins() {
                 p = 5.0f;
                 veinSpot[14]++;
                 for (auto i = 1; i < 12; i++) {
-                    if (dotNet35Random.nextDouble() >= 0.64999997615814209) break;
+                    if (dotNet35Random.nextRaw() >= RawMoreVein065) break;
                     veinSpot[14]++;
                 }
                 break;
             }
         }
 
-        auto rareVeinsSize = static_cast<int>(themeProto->rareVeins.size());
+        auto rareVeinsSize = static_cast<int>(themeProto->rareVeinCount);
+        const auto *rareVeins = themeHotTable.rareVeins(*themeProto);
         for (auto n = 0; n < rareVeinsSize; n++) {
-            auto num2 = themeProto->rareVeins[n];
-            auto num3 = themeProto->rareSettings[star->index == 0 ? (n * 4) : (n * 4 + 1)];
-            auto num4 = themeProto->rareSettings[n * 4 + 2];
+            auto num2 = rareVeins[n].vein;
+            auto num3 = star->index == 0 ? rareVeins[n].birthChance : rareVeins[n].chance;
+            auto raw4 = rareVeins[n].moreRawCutoff;
             num3 = 1.0f - std::pow(1.0f - num3, p);
             if (dotNet35Random.nextDouble() >= double(num3)) continue;
             veinSpot[num2]++;
             for (auto num7 = 1; num7 < 12; num7++) {
-                if (dotNet35Random.nextDouble() >= double(num4)) break;
+                if (dotNet35Random.nextRaw() >= raw4) break;
                 veinSpot[num2]++;
             }
         }
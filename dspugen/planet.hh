@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "util/arena.hh"
 #include <vector>
 #include <memory>
 
@@ -85,32 +86,21 @@ enum : int {
 
 }
 
+class Planet;
 class Star;
 class Galaxy;
 
-class Planet {
-public:
-    static void initThread();
-    static void releaseThread();
-
-    void release();
-
-    int id;
+/* Planet fields used while generating or read once per planet */
+struct PlanetCold {
     int index;
     int number;
     int seed;
 
     Galaxy *galaxy = nullptr;
-    Star *star = nullptr;
-    EPlanetType type = EPlanetType::None;
-    int singularity = 0;
-    int theme = 0;
     int algoId = 0;
 
-    int orbitAround = 0;
-    Planet *orbitAroundPlanet = nullptr;
     int orbitIndex = 0;
-    float orbitRadius = 1.0f;
+    Planet *orbitAroundPlanet = nullptr;
     float radius = 200.0f;
     float scale = 1.0f;
     float habitableBias = 0.0f;
@@ -138,24 +128,58 @@ public:
     bool levelized = false;
     int iceFlag = 0;
 */
-    std::vector<int> gasItems;
-    std::vector<float> gasSpeeds;
+    util::ArenaArray<int> gasItems;
+    util::ArenaArray<float> gasSpeeds;
 /*
     std::vector<float> gasHeatValues;
     double gasTotalHeat = 0.0;
 */
-    int veinSpot[15] = {};
     int themeSeed = 0;
+};
+
+/* Hot part of a planet with the fields filters test per planet,
+ * the rest is in `cold` and read through the accessors below */
+class Planet {
+public:
+    Star *star = nullptr;
+    PlanetCold *cold = nullptr;
+    int id;
+    EPlanetType type = EPlanetType::None;
+    int theme = 0;
+    int singularity = 0;
+    int orbitAround = 0;
+    float orbitRadius = 1.0f;
+    int veinSpot[15] = {};
 
+    [[nodiscard]] inline const util::ArenaArray<int> &gasItems() const { return cold->gasItems; }
+    [[nodiscard]] inline const util::ArenaArray<float> &gasSpeeds() const { return cold->gasSpeeds; }
+    [[nodiscard]] inline const Planet *orbitAroundPlanet() const { return cold->orbitAroundPlanet; }
+    [[nodiscard]] inline Galaxy *galaxy() const { return cold->galaxy; }
+    [[nodiscard]] inline int index() const { return cold->index; }
+    [[nodiscard]] inline int number() const { return cold->number; }
+    [[nodiscard]] inline int seed() const { return cold->seed; }
+    [[nodiscard]] inline int algoId() const { return cold->algoId; }
+    [[nodiscard]] inline int orbitIndex() const { return cold->orbitIndex; }
+    [[nodiscard]] inline float radius() const { return cold->radius; }
+    [[nodiscard]] inline float scale() const { return cold->scale; }
+    [[nodiscard]] inline float habitableBias() const { return cold->habitableBias; }
+    [[nodiscard]] inline float sunDistance() const { return cold->sunDistance; }
+    [[nodiscard]] inline float temperatureBias() const { return cold->temperatureBias; }
+    [[nodiscard]] inline float luminosity() const { return cold->luminosity; }
+    [[nodiscard]] inline int themeSeed() const { return cold->themeSeed; }
+
+    /* Fills `star->planets()[index]`, laid out by the star beforehand */
     static Planet *create(Star *star, int index, int orbitAround, int orbitIndex, int number, bool gasGiant, int infoSeed, int genSeed);
 
-    [[nodiscard]] inline float realRadius() const { return radius * scale; }
+    [[nodiscard]] inline float realRadius() const { return cold->radius * cold->scale; }
 
     void generateGas();
+    /* Run by create() unless the galaxy has `noVeins`, call it once at most otherwise.
+     * Only reads this planet and its star, planets can get their veins in parallel */
+    void generateVeins();
 
 private:
     void setPlanetTheme(double rand1, double rand2, double rand3, double rand4, int thmSeed);
-    void generateVeins();
 };
 
 }
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+/* Build step of dspugen: reads the prototype JSON files and writes them out as the
+ * static tables of prototables.hh, so that nothing is parsed at run time.
+ * Usage: protogen <Prototypes dir> <output .cc> */
+
+#include "prototables.hh"
+
+#include <fmt/format.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace dspugen;
+
+/* Arrays of all records go into one pool per element type, spans point into those */
+class Writer {
+public:
+    std::string span(const std::vector<int> &values) {
+        return span(values, ints_, "ints", [](int v) { return fmt::format("{}", v); });
+    }
+
+    std::string span(const std::vector<float> &values) {
+        return span(values, floats_, "floats", [](float v) { return floatLiteral(v); });
+    }
+
+    /* Hex literals keep every bit of the parsed value */
+    static std::string floatLiteral(float value) {
+        return fmt::format("{:a}f", value);
+    }
+
+    /* Octal escapes for anything outside printable ASCII, they never run into the next char */
+    static std::string stringLiteral(const std::string &str) {
+        std::string out = "\"";
+        for (auto c: str) {
+            auto u = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (u < 0x20 || u >= 0x7F) {
+                out += fmt::format("\\{:03o}", u);
+            } else {
+                out += c;
+            }
+        }
+        out += '"';
+        return out;
+    }
+
+    void writePools(std::FILE *f) const {
+        writePool(f, "int", "ints", ints_);
+        writePool(f, "float", "floats", floats_);
+    }
+
+private:
+    template<typename T, typename Format>
+    static std::string span(const std::vector<T> &values, std::vector<std::string> &pool, const char *poolName,
+                            Format format) {
+        if (values.empty()) return "{nullptr, 0}";
+        auto offset = pool.size();
+        for (auto v: values) pool.push_back(format(v));
+        return fmt::format("{{{} + {}, {}}}", poolName, offset, values.size());
+    }
+
+    static void writePool(std::FILE *f, const char *type, const char *name, const std::vector<std::string> &pool) {
+        fmt::print(f, "static const {} {}[] = {{", type, name);
+        if (pool.empty()) fmt::print(f, "0");
+        for (size_t i = 0; i < pool.size(); i++) {
+            fmt::print(f, "{}{}", i % 8 == 0 ? "\n    " : " ", pool[i]);
+            if (i + 1 < pool.size()) fmt::print(f, ",");
+        }
+        fmt::print(f, "\n}};\n\n");
+    }
+
+    std::vector<std::string> ints_;
+    std::vector<std::string> floats_;
+};
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fmt::print(stderr, "Usage: protogen <Prototypes dir> <output .cc>\n");
+        return 1;
+    }
+    ThemeProtoSet themes;
+    ItemProtoSet items;
+    VeinProtoSet veins;
+    StringProtoSet strings;
+    if (!prototables::readJsonDir(argv[1], themes, items, veins, &strings)) {
+        fmt::print(stderr, "protogen: missing prototype files in {}\n", argv[1]);
+        return 1;
+    }
+
+    Writer w;
+    std::vector<std::string> records;
+    for (const auto &p: themes.dataArray) {
+        records.push_back(fmt::format(
+            "{{{}, {}, {}, {}, {}, {},\n"
+            "     {}, {}, {}, {}, {}}}",
+            p.id, Writer::stringLiteral(p.name), p.planetType, w.span(p.algos), p.distribute,
+            Writer::floatLiteral(p.temperature), w.span(p.veinSpot), w.span(p.rareVeins),
+            w.span(p.rareSettings), w.span(p.gasItems), w.span(p.gasSpeeds)));
+    }
+
+    auto *f = std::fopen(argv[2], "wb");
+    if (!f) {
+        fmt::print(stderr, "protogen: unable to write {}\n", argv[2]);
+        return 1;
+    }
+    fmt::print(f, "/* Generated by protogen from the prototype JSON files, do not edit */\n\n");
+    fmt::print(f, "#include \"prototables.hh\"\n\nnamespace dspugen::prototables {{\n\n");
+    w.writePools(f);
+
+    fmt::print(f, "const Theme themeTable[] = {{\n");
+    for (const auto &r: records) fmt::print(f, "    {},\n", r);
+    fmt::print(f, "}};\nconst int themeTableSize = {};\n\n", records.size());
+
+    fmt::print(f, "const Item itemTable[] = {{\n");
+    for (const auto &p: items.dataArray) {
+        fmt::print(f, "    {{{}, {}, {}LL}},\n", p.id, Writer::stringLiteral(p.name), p.heatValue);
+    }
+    fmt::print(f, "}};\nconst int itemTableSize = {};\n\n", items.dataArray.size());
+
+    fmt::print(f, "const Vein veinTable[] = {{\n");
+    for (const auto &p: veins.dataArray) {
+        fmt::print(f, "    {{{}, {}, {}, {}, {}}},\n", p.id, Writer::stringLiteral(p.name), p.miningItem,
+                   p.modelCount, p.modelIndex);
+    }
+    fmt::print(f, "}};\nconst int veinTableSize = {};\n\n", veins.dataArray.size());
+
+    fmt::print(f, "const String stringTable[] = {{\n");
+    for (const auto &p: strings.dataArray) {
+        fmt::print(f, "    {{{}, {}, {}, {}}},\n", Writer::stringLiteral(p.name), Writer::stringLiteral(p.zhcn),
+                   Writer::stringLiteral(p.enus), Writer::stringLiteral(p.frfr));
+    }
+    fmt::print(f, "}};\nconst int stringTableSize = {};\n\n}}\n", strings.dataArray.size());
+    return std::fclose(f) == 0 ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+#include "prototables.hh"
+
+#include <nlohmann/json.hpp>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <variant>
+
+namespace dspugen::prototables {
+
+/* JSON key of a proto field and where it goes. Keys not listed are skipped by the reader */
+template<typename T>
+struct Field {
+    std::string_view key;
+    std::variant<int T::*, float T::*, int64_t T::*, std::string T::*,
+                 std::vector<int> T::*, std::vector<float> T::*> member;
+};
+
+template<typename T>
+struct Fields;
+
+template<>
+struct Fields<ThemeProto> {
+    static constexpr Field<ThemeProto> list[] = {
+        {"ID", &ThemeProto::id},
+        {"Name", &ThemeProto::name},
+        {"PlanetType", &ThemeProto::planetType},
+        {"Algos", &ThemeProto::algos},
+        {"Distribute", &ThemeProto::distribute},
+        {"Temperature", &ThemeProto::temperature},
+        {"VeinSpot", &ThemeProto::veinSpot},
+        {"RareVeins", &ThemeProto::rareVeins},
+        {"RareSettings", &ThemeProto::rareSettings},
+        {"GasItems", &ThemeProto::gasItems},
+        {"GasSpeeds", &ThemeProto::gasSpeeds},
+    };
+};
+
+template<>
+struct Fields<ItemProto> {
+    static constexpr Field<ItemProto> list[] = {
+        {"ID", &ItemProto::id},
+        {"Name", &ItemProto::name},
+        {"HeatValue", &ItemProto::heatValue},
+    };
+};
+
+template<>
+struct Fields<VeinProto> {
+    static constexpr Field<VeinProto> list[] = {
+        {"ID", &VeinProto::id},
+        {"Name", &VeinProto::name},
+        {"MiningItem", &VeinProto::miningItem},
+        {"ModelCount", &VeinProto::modelCount},
+        {"ModelIndex", &VeinProto::modelIndex},
+    };
+};
+
+template<>
+struct Fields<StringProto> {
+    static constexpr Field<StringProto> list[] = {
+        {"Name", &StringProto::name},
+        {"ZHCN", &StringProto::zhcn},
+        {"ENUS", &StringProto::enus},
+        {"FRFR", &StringProto::frfr},
+    };
+};
+
+/* SAX handler writing the records of `dataArray` straight into the proto set.
+ * Depths: 1 the file object, 2 `dataArray`, 3 a record, 4 an array field of it */
+template<typename T>
+class RecordReader final : public nlohmann::json_sax<nlohmann::json> {
+public:
+    RecordReader(std::string path, std::vector<T> &records): path_(std::move(path)), records_(records) {}
+
+    bool null() override { return skipValue(); }
+    bool boolean(bool val) override { return number(val ? 1 : 0); }
+    bool number_integer(number_integer_t val) override { return number(val); }
+    bool number_unsigned(number_unsigned_t val) override { return number(val); }
+    bool number_float(number_float_t val, const string_t &) override { return number(val); }
+    bool binary(binary_t &) override { return skipValue(); }
+
+    bool string(string_t &val) override {
+        if (depth_ == 3 && field_) {
+            if (auto *member = std::get_if<std::string T::*>(&field_->member)) records_.back().*(*member) = std::move(val);
+            field_ = nullptr;
+        }
+        return skipValue();
+    }
+
+    bool start_object(std::size_t) override {
+        if (depth_ == 2 && inData_) records_.emplace_back();
+        if (depth_ == 3) field_ = nullptr;
+        depth_++;
+        return true;
+    }
+
+    bool key(string_t &val) override {
+        if (depth_ == 1) {
+            dataNext_ = val == "dataArray";
+        } else if (depth_ == 3) {
+            field_ = nullptr;
+            for (const auto &field: Fields<T>::list) {
+                if (field.key == val) {
+                    field_ = &field;
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        depth_--;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (depth_ == 1 && dataNext_) inData_ = true;
+        if (depth_ == 3) {
+            /* Only array fields take the elements, anything else is skipped */
+            inArray_ = field_ && (std::holds_alternative<std::vector<int> T::*>(field_->member)
+                                  || std::holds_alternative<std::vector<float> T::*>(field_->member));
+            if (!inArray_) field_ = nullptr;
+        }
+        depth_++;
+        return true;
+    }
+
+    bool end_array() override {
+        depth_--;
+        if (depth_ == 1) inData_ = false;
+        if (depth_ == 3) {
+            inArray_ = false;
+            field_ = nullptr;
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &ex) override {
+        throw std::runtime_error(path_ + ": " + ex.what());
+    }
+
+private:
+    /* Values get the conversions from_json() would make */
+    template<typename V>
+    bool number(V val) {
+        if (depth_ == 3 && field_ && !inArray_) {
+            auto &record = records_.back();
+            if (auto *member = std::get_if<int T::*>(&field_->member)) record.*(*member) = static_cast<int>(val);
+            else if (auto *member = std::get_if<float T::*>(&field_->member)) record.*(*member) = static_cast<float>(val);
+            else if (auto *member = std::get_if<int64_t T::*>(&field_->member)) record.*(*member) = static_cast<int64_t>(val);
+            field_ = nullptr;
+        } else if (depth_ == 4 && inArray_) {
+            auto &record = records_.back();
+            if (auto *member = std::get_if<std::vector<int> T::*>(&field_->member)) (record.*(*member)).push_back(static_cast<int>(val));
+            else if (auto *member = std::get_if<std::vector<float> T::*>(&field_->member)) (record.*(*member)).push_back(static_cast<float>(val));
+        }
+        return skipValue();
+    }
+
+    bool skipValue() {
+        if (depth_ == 1) dataNext_ = false;
+        if (depth_ == 3) field_ = nullptr;
+        return true;
+    }
+
+    std::string path_;
+    std::vector<T> &records_;
+    const Field<T> *field_ = nullptr;
+    int depth_ = 0;
+    bool dataNext_ = false;
+    bool inData_ = false;
+    bool inArray_ = false;
+};
+
+template<typename T>
+bool readJson(const std::string &path, ProtoSet<T> &set) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open()) return false;
+    std::string text((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    set.dataArray.clear();
+    RecordReader<T> reader(path, set.dataArray);
+    nlohmann::json::sax_parse(text, &reader);
+    return true;
+}
+
+template bool readJson(const std::string &, ThemeProtoSet &);
+template bool readJson(const std::string &, ItemProtoSet &);
+template bool readJson(const std::string &, VeinProtoSet &);
+template bool readJson(const std::string &, StringProtoSet &);
+
+bool readJsonDir(const std::string &dir, ThemeProtoSet &themes, ItemProtoSet &items, VeinProtoSet &veins,
+                 StringProtoSet *strings) {
+    struct Job {
+        bool ok = true;
+        std::exception_ptr error;
+        std::thread thread;
+    };
+    Job jobs[4];
+    auto start = [&dir](Job &job, const char *filename, auto &set) {
+        job.thread = std::thread([&job, path = dir + "/" + filename, &set] {
+            try {
+                job.ok = readJson(path, set);
+            } catch (...) {
+                job.error = std::current_exception();
+            }
+        });
+    };
+    start(jobs[0], "ThemeProtoSet.json", themes);
+    start(jobs[1], "ItemProtoSet.json", items);
+    start(jobs[2], "VeinProtoSet.json", veins);
+    if (strings) start(jobs[3], "StringProtoSet.json", *strings);
+    auto ok = true;
+    for (auto &job: jobs) {
+        if (job.thread.joinable()) job.thread.join();
+        ok = ok && job.ok;
+    }
+    for (auto &job: jobs) {
+        if (job.error) std::rethrow_exception(job.error);
+    }
+    return ok;
+}
+
+}
@@ -8,109 +8,250 @@
 
 #include "protoset.hh"
 
-#include <nlohmann/json.hpp>
+#include "planet.hh"
+#include "prototables.hh"
+#include "util/dotnet35random.hh"
+
+#include <atomic>
+#include <cmath>
 #include <fstream>
+#include <mutex>
+#include <stdexcept>
 
 namespace dspugen {
 
 ThemeProtoSet themeProtoSet;
 ItemProtoSet itemProtoSet;
 VeinProtoSet veinProtoSet;
-StringProtoSet stringProtoSet;
+ThemeHotTable themeHotTable;
+
+/* Strings make up most of the game data and only translate() reads them. Loading
+ * them is left to the first call, from the directory of the last loadProtoSets(),
+ * or the built-in tables if empty */
+static StringProtoSet strings;
+static std::string stringsDir;
+static std::atomic<bool> stringsLoaded {false};
+static std::mutex stringsMutex;
 
-#define JL(a, b) j.at(#a).get_to(p.b)
-void from_json(const nlohmann::json &j, Vector2 &p) {
-    JL(x, x);
-    JL(y, y);
+template<typename T>
+static std::vector<T> toVector(const prototables::Span<T> &span) {
+    return {span.data, span.data + span.size};
 }
 
-void from_json(const nlohmann::json &j, ThemeProto &p) {
-    JL(ID, id);
-    JL(Name, name);
-    JL(DisplayName, displayName);
-    JL(PlanetType, planetType);
-    JL(Algos, algos);
-    JL(Distribute, distribute);
-    JL(Temperature, temperature);
-    JL(ModX, modX);
-    JL(ModY, modY);
-    JL(Vegetables0, vegetables0);
-    JL(Vegetables1, vegetables1);
-    JL(Vegetables2, vegetables2);
-    JL(Vegetables3, vegetables3);
-    JL(Vegetables4, vegetables4);
-    JL(Vegetables5, vegetables5);
-    JL(VeinSpot, veinSpot);
-    JL(VeinCount, veinCount);
-    JL(VeinOpacity, veinOpacity);
-    JL(RareVeins, rareVeins);
-    JL(RareSettings, rareSettings);
-    JL(GasItems, gasItems);
-    JL(GasSpeeds, gasSpeeds);
-    JL(UseHeightForBuild, useHeightForBuild);
-    JL(IonHeight, ionHeight);
-    JL(WaterHeight, waterHeight);
-    JL(WaterItemId, waterItemId);
-    JL(IceFlag, iceFlag);
-    JL(Wind, wind);
+/* Appends `values` to `pool`, returning the offset and count for the packed fields */
+template<typename T>
+static void appendRange(std::vector<T> &pool, const std::vector<T> &values, uint16_t &offset, uint16_t &count) {
+    if (pool.size() + values.size() > UINT16_MAX) throw std::length_error("theme data does not fit the hot table");
+    offset = static_cast<uint16_t>(pool.size());
+    count = static_cast<uint16_t>(values.size());
+    pool.insert(pool.end(), values.begin(), values.end());
 }
 
-void from_json(const nlohmann::json &j, ItemProto &p) {
-    JL(ID, id);
-    JL(Name, name);
-    JL(HeatValue, heatValue);
+void ThemeHotTable::build(const ThemeProtoSet &set) {
+    themes_.clear();
+    indices_.clear();
+    ints_.clear();
+    floats_.clear();
+    rares_.clear();
+    themes_.reserve(set.dataArray.size());
+    for (const auto &proto: set.dataArray) {
+        if (proto.id < 0 || proto.id > INT16_MAX || themes_.size() >= size_t(INT16_MAX)) {
+            throw std::out_of_range("theme ID " + std::to_string(proto.id) + " does not fit the hot table");
+        }
+        ThemeHot hot = {};
+        hot.id = proto.id;
+        hot.planetType = proto.planetType;
+        hot.distribute = proto.distribute;
+        hot.temperature = proto.temperature;
+        appendRange(ints_, proto.algos, hot.algos, hot.algoCount);
+        appendRange(ints_, proto.veinSpot, hot.veinSpot, hot.veinSpotCount);
+        appendRange(ints_, proto.gasItems, hot.gasItems, hot.gasItemCount);
+        appendRange(floats_, proto.gasSpeeds, hot.gasSpeeds, hot.gasSpeedCount);
+        if (rares_.size() + proto.rareVeins.size() > UINT16_MAX) throw std::length_error("theme data does not fit the hot table");
+        if (proto.rareSettings.size() < proto.rareVeins.size() * 4) {
+            throw std::length_error("theme " + std::to_string(proto.id) + " lacks rare vein settings");
+        }
+        hot.rareVeins = static_cast<uint16_t>(rares_.size());
+        hot.rareVeinCount = static_cast<uint16_t>(proto.rareVeins.size());
+        for (size_t n = 0; n < proto.rareVeins.size(); n++) {
+            const auto *settings = &proto.rareSettings[n * 4];
+            rares_.push_back({proto.rareVeins[n], settings[0], settings[1], util::DotNet35Random::rawAtLeast(double(settings[2]))});
+        }
+        if (proto.id >= static_cast<int>(indices_.size())) indices_.resize(proto.id + 1, -1);
+        indices_[proto.id] = static_cast<int16_t>(themes_.size());
+        themes_.push_back(hot);
+    }
+    buildMasks();
 }
 
-void from_json(const nlohmann::json &j, VeinProto &p) {
-    JL(ID, id);
-    JL(Name, name);
-    JL(MiningItem, miningItem);
-    JL(ModelCount, modelCount);
-    JL(ModelIndex, modelIndex);
+/* The temperature part of ThemeHotTable::fits(). It passes at a bias of 0 and over
+ * one interval around it, as the products and comparisons are monotonic in the bias */
+static bool temperatureFits(const ThemeHot &theme, float temperatureBias) {
+    if (std::abs(theme.temperature) < 0.5f && theme.planetType == static_cast<int>(EPlanetType::Desert)) {
+        return std::abs(temperatureBias) < std::abs(theme.temperature) + 0.1f;
+    }
+    return theme.temperature * temperatureBias >= -0.1f;
+}
+
+bool ThemeHotTable::fits(const ThemeHot &theme, int planetType, bool birthStar, float temperatureBias) {
+    if (birthStar && planetType == static_cast<int>(EPlanetType::Ocean)) {
+        return theme.distribute == EThemeDistribute::Birth;
+    }
+    if (theme.planetType != planetType || !temperatureFits(theme, temperatureBias)) return false;
+    if (birthStar) return theme.distribute == EThemeDistribute::Default;
+    return theme.distribute == EThemeDistribute::Default || theme.distribute == EThemeDistribute::Interstellar;
+}
+
+void ThemeHotTable::buildMasks() {
+    biasBreaks_.clear();
+    candidateMasks_.clear();
+    idMasks_.clear();
+    desertMask_ = 0;
+    maskPlanetTypes_ = 0;
+    auto count = static_cast<int>(themes_.size());
+    if (count > MaskThemes) return;
+
+    auto biasAt = [](int64_t key) {
+        auto bits = static_cast<int32_t>(key);
+        if (bits < 0) bits ^= INT32_MAX;
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    };
+    maskPlanetTypes_ = static_cast<int>(EPlanetType::Ocean) + 1;
+    for (int i = 0; i < count; i++) {
+        const auto &theme = themes_[i];
+        maskPlanetTypes_ = std::max(maskPlanetTypes_, theme.planetType + 1);
+        if (theme.planetType == static_cast<int>(EPlanetType::Desert)) desertMask_ |= 1u << i;
+        if (theme.id >= static_cast<int>(idMasks_.size())) idMasks_.resize(theme.id + 1, 0);
+        idMasks_[theme.id] |= 1u << i;
+
+        /* Exact ends of the interval where the temperature test passes: the first
+         * key that passes below 0, and the first that fails above */
+        int64_t lo = INT32_MIN, hi = 0;
+        while (lo < hi) {
+            auto mid = lo + (hi - lo) / 2;
+            if (temperatureFits(theme, biasAt(mid))) hi = mid; else lo = mid + 1;
+        }
+        if (lo > INT32_MIN) biasBreaks_.push_back(static_cast<int32_t>(lo));
+        lo = 0;
+        hi = INT32_MAX;
+        while (lo < hi) {
+            auto mid = lo + (hi - lo + 1) / 2;
+            if (temperatureFits(theme, biasAt(mid))) lo = mid; else hi = mid - 1;
+        }
+        if (lo < INT32_MAX) biasBreaks_.push_back(static_cast<int32_t>(lo + 1));
+    }
+    std::sort(biasBreaks_.begin(), biasBreaks_.end());
+    biasBreaks_.erase(std::unique(biasBreaks_.begin(), biasBreaks_.end()), biasBreaks_.end());
+
+    /* Every test is the same over an interval, so its first key stands for all of it */
+    auto intervals = biasBreaks_.size() + 1;
+    candidateMasks_.assign(intervals * maskPlanetTypes_ * 2, 0);
+    for (size_t interval = 0; interval < intervals; interval++) {
+        auto bias = biasAt(interval == 0 ? INT32_MIN : biasBreaks_[interval - 1]);
+        for (int planetType = 0; planetType < maskPlanetTypes_; planetType++) {
+            for (int birthStar = 0; birthStar < 2; birthStar++) {
+                uint32_t mask = 0;
+                for (int i = 0; i < count; i++) {
+                    if (fits(themes_[i], planetType, birthStar != 0, bias)) mask |= 1u << i;
+                }
+                candidateMasks_[(interval * maskPlanetTypes_ + planetType) * 2 + birthStar] = mask;
+            }
+        }
+    }
 }
 
-void from_json(const nlohmann::json &j, StringProto &p) {
-    JL(Name, name);
-    JL(ZHCN, zhcn);
-    JL(ENUS, enus);
-    JL(FRFR, frfr);
+/* Lookups and fields derived from the loaded data, whichever way it was loaded */
+static void onProtoSetsLoaded() {
+    themeProtoSet.onLoaded();
+    itemProtoSet.onLoaded();
+    veinProtoSet.onLoaded();
+    themeHotTable.build(themeProtoSet);
 }
 
-#undef JL
+static void resetStrings(const std::string &dir) {
+    std::unique_lock lock(stringsMutex);
+    strings = StringProtoSet();
+    stringsDir = dir;
+    stringsLoaded.store(false, std::memory_order_release);
+}
 
 void loadProtoSets() {
-    {
-        nlohmann::json j;
-        std::ifstream ifs("Prototypes/ThemeProtoSet.json");
-        ifs >> j;
-        j["dataArray"].get_to(themeProtoSet.dataArray);
-        themeProtoSet.onLoaded();
+    using namespace prototables;
+    themeProtoSet.init(themeTableSize);
+    for (int i = 0; i < themeTableSize; i++) {
+        const auto &r = themeTable[i];
+        auto &p = themeProtoSet.dataArray[i];
+        p.id = r.id;
+        p.name = r.name;
+        p.planetType = r.planetType;
+        p.algos = toVector(r.algos);
+        p.distribute = r.distribute;
+        p.temperature = r.temperature;
+        p.veinSpot = toVector(r.veinSpot);
+        p.rareVeins = toVector(r.rareVeins);
+        p.rareSettings = toVector(r.rareSettings);
+        p.gasItems = toVector(r.gasItems);
+        p.gasSpeeds = toVector(r.gasSpeeds);
     }
-    {
-        nlohmann::json j;
-        std::ifstream ifs("Prototypes/ItemProtoSet.json");
-        ifs >> j;
-        j["dataArray"].get_to(itemProtoSet.dataArray);
-        itemProtoSet.onLoaded();
+    itemProtoSet.init(itemTableSize);
+    for (int i = 0; i < itemTableSize; i++) {
+        const auto &r = itemTable[i];
+        auto &p = itemProtoSet.dataArray[i];
+        p.id = r.id;
+        p.name = r.name;
+        p.heatValue = r.heatValue;
     }
-    {
-        nlohmann::json j;
-        std::ifstream ifs("Prototypes/VeinProtoSet.json");
-        ifs >> j;
-        j["dataArray"].get_to(veinProtoSet.dataArray);
-        veinProtoSet.onLoaded();
+    veinProtoSet.init(veinTableSize);
+    for (int i = 0; i < veinTableSize; i++) {
+        const auto &r = veinTable[i];
+        auto &p = veinProtoSet.dataArray[i];
+        p.id = r.id;
+        p.name = r.name;
+        p.miningItem = r.miningItem;
+        p.modelCount = r.modelCount;
+        p.modelIndex = r.modelIndex;
     }
-    {
-        nlohmann::json j;
-        std::ifstream ifs("Prototypes/StringProtoSet.json");
-        ifs >> j;
-        j["dataArray"].get_to(stringProtoSet.dataArray);
-        stringProtoSet.onLoaded();
+    onProtoSetsLoaded();
+    resetStrings({});
+}
+
+bool loadProtoSets(const std::string &dir) {
+    /* Opened here so that a missing file still fails the load */
+    if (!std::ifstream(dir + "/StringProtoSet.json").is_open()) return false;
+    if (!prototables::readJsonDir(dir, themeProtoSet, itemProtoSet, veinProtoSet, nullptr)) return false;
+    onProtoSetsLoaded();
+    resetStrings(dir);
+    return true;
+}
+
+const StringProtoSet &stringProtoSet() {
+    if (stringsLoaded.load(std::memory_order_acquire)) return strings;
+    std::unique_lock lock(stringsMutex);
+    if (stringsLoaded.load(std::memory_order_relaxed)) return strings;
+    if (stringsDir.empty()) {
+        using namespace prototables;
+        strings.init(stringTableSize);
+        for (int i = 0; i < stringTableSize; i++) {
+            const auto &r = stringTable[i];
+            auto &p = strings.dataArray[i];
+            p.id = 0;
+            p.name = r.name;
+            p.zhcn = r.zhcn;
+            p.enus = r.enus;
+            p.frfr = r.frfr;
+        }
+    } else {
+        prototables::readJson(stringsDir + "/StringProtoSet.json", strings);
     }
+    strings.onLoaded();
+    stringsLoaded.store(true, std::memory_order_release);
+    return strings;
 }
 
-const std::string &translate(const std::string &name, int type) {
-    const auto *val = stringProtoSet.select(name);
+const std::string &translate(std::string_view name, int type) {
+    const auto *val = stringProtoSet().select(name);
     if (val) {
         switch (type) {
             case 1:
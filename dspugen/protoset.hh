@@ -8,12 +8,13 @@
 
 #pragma once
 
-#include "vectors.hh"
-
 #include <unordered_map>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 namespace dspugen {
 
@@ -31,8 +32,13 @@ enum : int {
 template<typename T>
 class ProtoSet {
 private:
-    std::unordered_map<int, int> dataIndices;
-    std::unordered_map<std::string, int> nameIndices;
+    /* IDs below the limit index `denseIndices` directly, -1 where there is no proto,
+     * any others go to `sparseIndices` */
+    static constexpr int DenseIdLimit = 0x10000;
+    std::vector<int> denseIndices;
+    std::unordered_map<int, int> sparseIndices;
+    /* `dataArray` indices sorted by name for binary search, one per name */
+    std::vector<int> nameOrder;
 
 public:
     std::vector<T> dataArray;
@@ -46,24 +52,59 @@ public:
         dataArray.resize(length);
     }
 
+    /* Index into `dataArray`, -1 if not found */
+    [[nodiscard]] inline int indexOf(int id) const {
+        if (id >= 0 && id < static_cast<int>(denseIndices.size())) return denseIndices[id];
+        if (sparseIndices.empty()) return -1;
+        auto ite = sparseIndices.find(id);
+        return ite == sparseIndices.end() ? -1 : ite->second;
+    }
+
     inline const T *select(int id) const {
-        auto ite = dataIndices.find(id);
-        if (ite == dataIndices.end()) { return nullptr; }
-        return &dataArray[ite->second];
+        auto index = indexOf(id);
+        return index < 0 ? nullptr : &dataArray[index];
     }
 
-    inline const T *select(const std::string &name) const {
-        auto ite = nameIndices.find(name);
-        if (ite == nameIndices.end()) { return nullptr; }
-        return &dataArray[ite->second];
+    inline const T *select(std::string_view name) const {
+        auto ite = std::lower_bound(nameOrder.begin(), nameOrder.end(), name, [this](int index, std::string_view value) {
+            return std::string_view(dataArray[index].name) < value;
+        });
+        if (ite == nameOrder.end() || dataArray[*ite].name != name) { return nullptr; }
+        return &dataArray[*ite];
     }
 
     inline void onLoaded() {
+        denseIndices.clear();
+        sparseIndices.clear();
+        nameOrder.clear();
         auto count = static_cast<int>(dataArray.size());
+        int maxId = -1;
+        for (const auto &data: dataArray) {
+            if (data.id < DenseIdLimit) maxId = std::max(maxId, data.id);
+        }
+        denseIndices.assign(maxId + 1, -1);
+        nameOrder.reserve(count);
         for (int i = 0; i < count; ++i) {
-            dataIndices[dataArray[i].id] = i;
-            nameIndices[dataArray[i].name] = i;
+            auto id = dataArray[i].id;
+            if (id >= 0 && id < DenseIdLimit) {
+                denseIndices[id] = i;
+            } else {
+                sparseIndices[id] = i;
+            }
+            nameOrder.push_back(i);
+        }
+        /* Stable, so the last proto of a name is the last of its run and is the one
+         * kept, as with duplicate IDs */
+        std::stable_sort(nameOrder.begin(), nameOrder.end(), [this](int a, int b) {
+            return dataArray[a].name < dataArray[b].name;
+        });
+        auto out = nameOrder.begin();
+        for (auto ite = nameOrder.begin(); ite != nameOrder.end(); ++ite) {
+            auto next = ite + 1;
+            if (next != nameOrder.end() && dataArray[*next].name == dataArray[*ite].name) continue;
+            *out++ = *ite;
         }
+        nameOrder.erase(out, nameOrder.end());
     }
 };
 
@@ -72,33 +113,17 @@ struct Proto {
     std::string name;
 };
 
+/* Only the fields generation reads, the loaders skip the rest of the game data */
 struct ThemeProto : Proto {
     std::vector<int> algos;
-    std::string displayName;
     int distribute = 0;
     std::vector<int> gasItems;
     std::vector<float> gasSpeeds;
-    int iceFlag = 0;
-    float ionHeight = 0.0f;
-    Vector2 modX;
-    Vector2 modY;
     int planetType = 0;
     std::vector<float> rareSettings;
     std::vector<int> rareVeins;
     float temperature = 0.0f;
-    bool useHeightForBuild = false;
-    std::vector<int> vegetables0;
-    std::vector<int> vegetables1;
-    std::vector<int> vegetables2;
-    std::vector<int> vegetables3;
-    std::vector<int> vegetables4;
-    std::vector<int> vegetables5;
-    std::vector<float> veinCount;
-    std::vector<float> veinOpacity;
     std::vector<int> veinSpot;
-    float waterHeight = 0.0f;
-    int waterItemId = 0;
-    float wind = 0.0f;
 };
 
 struct ItemProto : Proto {
@@ -118,7 +143,11 @@ struct StringProto : Proto {
     std::string frfr;
 };
 
+/* Fills the proto sets from the tables built into dspugen */
 extern void loadProtoSets();
+/* Fills them from the game data JSON files in `dir` instead, for data newer than the
+ * built-in tables. False if a file is missing, malformed ones throw */
+extern bool loadProtoSets(const std::string &dir);
 
 using ThemeProtoSet = ProtoSet<ThemeProto>;
 extern ThemeProtoSet themeProtoSet;
@@ -127,9 +156,100 @@ extern ItemProtoSet itemProtoSet;
 using VeinProtoSet = ProtoSet<VeinProto>;
 extern VeinProtoSet veinProtoSet;
 using StringProtoSet = ProtoSet<StringProto>;
-extern StringProtoSet stringProtoSet;
+/* Strings are only loaded once asked for, from wherever loadProtoSets() took the rest */
+extern const StringProtoSet &stringProtoSet();
+
+/* A rare vein of a theme as generation reads it */
+struct RareVeinHot {
+    int vein;
+    /* Chance of the vein around the birth star and elsewhere (`rareSettings` 0 and 1) */
+    float birthChance;
+    float chance;
+    /* Chance of one more spot (`rareSettings` 2) as a DotNet35Random::rawAtLeast() cutoff */
+    int moreRawCutoff;
+};
+
+/* Generation fields of a theme in 40 bytes, where a ThemeProto takes hundreds spread
+ * over its vectors. The arrays are offset/count ranges of the ThemeHotTable pools */
+struct ThemeHot {
+    int id;
+    int planetType;
+    int distribute;
+    float temperature;
+    uint16_t algos, algoCount;
+    uint16_t veinSpot, veinSpotCount;
+    uint16_t gasItems, gasItemCount;
+    uint16_t gasSpeeds, gasSpeedCount;
+    uint16_t rareVeins, rareVeinCount;
+};
+
+/* The themes laid out for generation, rebuilt by each loadProtoSets() */
+class ThemeHotTable {
+public:
+    /* Theme masks below are only built for up to this many themes */
+    static constexpr int MaskThemes = 32;
+
+    /* Throws if IDs or the pools don't fit the packed fields */
+    void build(const ThemeProtoSet &set);
+
+    /* In `dataArray` order */
+    [[nodiscard]] inline const std::vector<ThemeHot> &themes() const { return themes_; }
+    [[nodiscard]] inline const ThemeHot *select(int id) const {
+        if (id < 0 || id >= static_cast<int>(indices_.size()) || indices_[id] < 0) return nullptr;
+        return &themes_[indices_[id]];
+    }
+
+    /* Whether the theme is a first choice for a planet, as Planet::setPlanetTheme() decides */
+    static bool fits(const ThemeHot &theme, int planetType, bool birthStar, float temperatureBias);
+
+    /* The masks have bit i set for themes()[i] */
+    [[nodiscard]] inline bool hasMasks() const { return !candidateMasks_.empty(); }
+    /* Themes that fit(), found from the interval of the temperature bias */
+    [[nodiscard]] inline uint32_t candidateMask(int planetType, bool birthStar, float temperatureBias) const {
+        if (planetType < 0 || planetType >= maskPlanetTypes_) return 0;
+        auto interval = std::upper_bound(biasBreaks_.begin(), biasBreaks_.end(), biasKey(temperatureBias)) - biasBreaks_.begin();
+        return candidateMasks_[(interval * maskPlanetTypes_ + planetType) * 2 + (birthStar ? 1 : 0)];
+    }
+    /* Every theme with the ID */
+    [[nodiscard]] inline uint32_t idMask(int id) const {
+        return id >= 0 && id < static_cast<int>(idMasks_.size()) ? idMasks_[id] : 0;
+    }
+    [[nodiscard]] inline uint32_t desertMask() const { return desertMask_; }
+
+    [[nodiscard]] inline const int *algos(const ThemeHot &theme) const { return ints_.data() + theme.algos; }
+    [[nodiscard]] inline const int *veinSpot(const ThemeHot &theme) const { return ints_.data() + theme.veinSpot; }
+    [[nodiscard]] inline const int *gasItems(const ThemeHot &theme) const { return ints_.data() + theme.gasItems; }
+    [[nodiscard]] inline const float *gasSpeeds(const ThemeHot &theme) const { return floats_.data() + theme.gasSpeeds; }
+    [[nodiscard]] inline const RareVeinHot *rareVeins(const ThemeHot &theme) const { return rares_.data() + theme.rareVeins; }
+
+private:
+    std::vector<ThemeHot> themes_;
+    /* Index into `themes_` by ID, -1 where there is no theme */
+    std::vector<int16_t> indices_;
+    std::vector<int> ints_;
+    std::vector<float> floats_;
+    std::vector<RareVeinHot> rares_;
+
+    /* Floats as integers of the same order, with -0.0f just below 0.0f */
+    [[nodiscard]] static inline int32_t biasKey(float value) {
+        int32_t key;
+        memcpy(&key, &value, sizeof(key));
+        return key < 0 ? key ^ INT32_MAX : key;
+    }
+    void buildMasks();
+
+    /* Keys where the temperature test of some theme flips, sorted. Interval i of the
+     * bias is from biasBreaks_[i - 1] up to before biasBreaks_[i] */
+    std::vector<int32_t> biasBreaks_;
+    int maskPlanetTypes_ = 0;
+    /* [(interval * maskPlanetTypes_ + planetType) * 2 + birthStar] */
+    std::vector<uint32_t> candidateMasks_;
+    std::vector<uint32_t> idMasks_;
+    uint32_t desertMask_ = 0;
+};
+extern ThemeHotTable themeHotTable;
 
 /* for type: 0-ZHCN 1-ENUS 2-FRFR */
-extern const std::string &translate(const std::string &name, int type = 0);
+extern const std::string &translate(std::string_view name, int type = 0);
 
 }
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+#pragma once
+
+#include "protoset.hh"
+
+#include <cstdint>
+#include <string>
+
+/* Prototype tables built into dspugen. protogen reads the game data JSON files at
+ * build time and writes them out as the static records below (prototables.cc in the
+ * build directory), which loadProtoSets() copies into the proto sets on start */
+namespace dspugen::prototables {
+
+template<typename T>
+struct Span {
+    const T *data;
+    int size;
+};
+
+struct Theme {
+    int id;
+    const char *name;
+    int planetType;
+    Span<int> algos;
+    int distribute;
+    float temperature;
+    Span<int> veinSpot;
+    Span<int> rareVeins;
+    Span<float> rareSettings;
+    Span<int> gasItems;
+    Span<float> gasSpeeds;
+};
+
+struct Item {
+    int id;
+    const char *name;
+    int64_t heatValue;
+};
+
+struct Vein {
+    int id;
+    const char *name;
+    int miningItem;
+    int modelCount;
+    int modelIndex;
+};
+
+struct String {
+    const char *name;
+    const char *zhcn;
+    const char *enus;
+    const char *frfr;
+};
+
+extern const Theme themeTable[];
+extern const int themeTableSize;
+extern const Item itemTable[];
+extern const int itemTableSize;
+extern const Vein veinTable[];
+extern const int veinTableSize;
+extern const String stringTable[];
+extern const int stringTableSize;
+
+/* Streams the records of a game data JSON file into `set`, keeping only the fields
+ * the proto structs have. False if the file can not be opened, malformed ones throw */
+template<typename T>
+bool readJson(const std::string &path, ProtoSet<T> &set);
+/* The files of `dir`, each on its own thread. `strings` may be null to leave out
+ * StringProtoSet.json */
+bool readJsonDir(const std::string &dir, ThemeProtoSet &themes, ItemProtoSet &items, VeinProtoSet &veins,
+                 StringProtoSet *strings);
+
+}
@@ -6,6 +6,8 @@
  * https://opensource.org/licenses/MIT.
  */
 
+#pragma once
+
 namespace dspugen {
 
 struct Settings {
@@ -13,6 +15,10 @@ struct Settings {
     bool birthOnly = false;
     bool genName = false;
     bool noPosition = false;
+    /* Leave `veinSpot` empty, veins use their own generator and feed nothing else */
+    bool noVeins = false;
+    /* Fill gas of gas giants as their planets are built */
+    bool genGas = false;
 };
 
 extern Settings settings;
@@ -15,13 +15,17 @@
 #include "galaxy.hh"
 #include "star.hh"
 #include "namegen.hh"
-#include "settings.hh"
+#include "gencontext.hh"
 #include "util/dotnet35random.hh"
 #include "util/maths.hh"
-#include "util/mempool.hh"
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#if defined(DSPUGEN_STAR_PHYSICS_CHECK)
+#include <cstdio>
+#include <cstdlib>
+#endif
 
 namespace dspugen {
 
@@ -29,60 +33,82 @@ static float randNormal(float averageValue, float standardDeviation, double r1,
     return averageValue + standardDeviation * float(std::sqrt(-2.0 * std::log(1.0 - r1)) * std::sin(M_PI * 2.0 * r2));
 }
 
-static thread_local util::MemPool<Star> *spool;
-
-void Star::initThread() {
-    spool = new util::MemPool<Star>();
-}
+static_assert(sizeof(Star) == 64, "hot part of a star should fill one cache line");
 
-void Star::releaseThread() {
-    delete spool;
-}
-
-Star::~Star() {
-    for (auto *p: planets) {
-        p->release();
-    }
-}
 
-void Star::release() {
-    spool->release(this);
+Star *Star::createStar(GenContext &ctx,
+                       Galaxy *galaxy,
+                       const VectorLF3 &pos,
+                       int id,
+                       int seed,
+                       EStarType needtype,
+                       ESpectrType needSpectr) {
+    util::DotNet35Random dotNet35Random(seed);
+    auto seed2 = dotNet35Random.next();
+    auto seed3 = dotNet35Random.next();
+    dotNet35Random.next();
+    auto planetSeed = dotNet35Random.next();
+    util::DotNet35Random dotNet35Random2(seed3);
+    if (ctx.settings.genName)
+        return createStar<true>(galaxy, pos, id, seed, seed2, planetSeed, dotNet35Random2, needtype, needSpectr);
+    return createStar<false>(galaxy, pos, id, seed, seed2, planetSeed, dotNet35Random2, needtype, needSpectr);
 }
 
+template<bool GenName>
 Star *Star::createStar(Galaxy *galaxy,
                        const VectorLF3 &pos,
                        int id,
                        int seed,
+                       int seed2,
+                       int planetSeed,
+                       util::DotNet35Random &dotNet35Random2,
                        EStarType needtype,
                        ESpectrType needSpectr) {
-    static const auto log10_26 = std::log10(2.6);
-    static const auto log10_5 = std::log10(5.0);
-
-    auto *star = spool->alloc();
+    auto *star = galaxy->stars[id - 1];
     star->galaxy = galaxy;
     star->index = id - 1;
     if (galaxy->starCount > 1)
-        star->level = float(star->index) / float(galaxy->starCount - 1);
+        star->cold->level = float(star->index) / float(galaxy->starCount - 1);
     else
-        star->level = 0.0f;
+        star->cold->level = 0.0f;
     star->id = id;
-    star->seed = seed;
-    util::DotNet35Random dotNet35Random(seed);
-    auto seed2 = dotNet35Random.next();
-    auto seed3 = dotNet35Random.next();
+    star->cold->seed = seed;
+    star->cold->planetSeed = planetSeed;
     star->position = pos;
 
-    util::DotNet35Random dotNet35Random2(seed3);
-    auto num2 = dotNet35Random2.nextDouble();
-    auto num3 = dotNet35Random2.nextDouble();
-    auto num4 = dotNet35Random2.nextDouble();
-    auto rn = dotNet35Random2.nextDouble();
-    auto rt = dotNet35Random2.nextDouble();
-    auto num5 = (dotNet35Random2.nextDouble() - 0.5) * 0.2;
-    auto num6 = dotNet35Random2.nextDouble() * 0.2 + 0.9;
-    auto num7 = dotNet35Random2.nextDouble() * 0.4 - 0.2;
+    double draws[PhysicsDraws];
+    for (auto &draw: draws) draw = dotNet35Random2.nextDouble();
+    star->applyPhysics(draws, needtype, needSpectr);
+/*
+    star->uPosition = star->position * 2400000.0;
+*/
+    if constexpr (GenName) {
+        NameGen::randomStarName(seed2, star, galaxy);
+    }
+    return star;
+}
+
+template Star *Star::createStar<false>(Galaxy *, const VectorLF3 &, int, int, int, int, util::DotNet35Random &,
+                                       EStarType, ESpectrType);
+template Star *Star::createStar<true>(Galaxy *, const VectorLF3 &, int, int, int, int, util::DotNet35Random &,
+                                      EStarType, ESpectrType);
+
+static const double log10_26 = std::log10(2.6);
+static const double log10_5 = std::log10(5.0);
+
+/* Scalar reference of the star physics, the batched kernel in createStars()
+ * must give the same bits for every field */
+void Star::applyPhysics(const double *draws, EStarType needtype, ESpectrType needSpectr) {
+    auto num2 = draws[0];
+    auto num3 = draws[1];
+    auto num4 = draws[2];
+    auto rn = draws[3];
+    auto rt = draws[4];
+    auto num5 = (draws[5] - 0.5) * 0.2;
+    auto num6 = draws[6] * 0.2 + 0.9;
+    auto num7 = draws[7] * 0.4 - 0.2;
     auto num8 = std::pow(2.0, num7);
-    auto num9 = util::lerp(-0.98f, 0.88f, star->level);
+    auto num9 = util::lerp(-0.98f, 0.88f, cold->level);
     num9 = num9 >= 0.0f ? num9 + 0.65f : num9 - 0.65f;
     auto standardDeviation = 0.33f;
     if (needtype == EStarType::GiantStar) {
@@ -107,36 +133,36 @@ Star *Star::createStar(Galaxy *galaxy,
     num10 = float(std::clamp(num10, -2.4f, 4.65f) + num5 + 1.0f);
     switch (needtype) {
         case EStarType::BlackHole:
-            star->mass = 18.0f + (num2 * num3) * 30.0f;
+            cold->mass = 18.0f + (num2 * num3) * 30.0f;
             break;
         case EStarType::NeutronStar:
-            star->mass = 7.0f + num2 * 11.0f;
+            cold->mass = 7.0f + num2 * 11.0f;
             break;
         case EStarType::WhiteDwarf:
-            star->mass = 1.0f + num3 * 5.0f;
+            cold->mass = 1.0f + num3 * 5.0f;
             break;
         default:
-            star->mass = std::pow(2.0f, num10);
+            cold->mass = std::pow(2.0f, num10);
             break;
     }
 
-    auto d = star->mass < 2.0f ? (2.0 + 0.4 * (1.0 - star->mass)) : 5.0;
-    star->lifetime = 10000.0 * std::pow(0.1, std::log10(star->mass * 0.5) / std::log10(d) + 1.0) * num6;
+    auto d = cold->mass < 2.0f ? (2.0 + 0.4 * (1.0 - cold->mass)) : 5.0;
+    cold->lifetime = 10000.0 * std::pow(0.1, std::log10(cold->mass * 0.5) / std::log10(d) + 1.0) * num6;
     switch (needtype) {
         case EStarType::GiantStar:
-            star->lifetime = 10000.0 * std::pow(0.1, std::log10(star->mass * 0.58) / std::log10(d) + 1.0) * num6;
-            star->age = num4 * 0.04f + 0.96f;
+            cold->lifetime = 10000.0 * std::pow(0.1, std::log10(cold->mass * 0.58) / std::log10(d) + 1.0) * num6;
+            cold->age = num4 * 0.04f + 0.96f;
             break;
         case EStarType::WhiteDwarf:
         case EStarType::NeutronStar:
         case EStarType::BlackHole:
-            star->age = num4 * 0.4f + 1.0f;
+            cold->age = num4 * 0.4f + 1.0f;
             switch (needtype) {
                 case EStarType::WhiteDwarf:
-                    star->lifetime += 10000.0f;
+                    cold->lifetime += 10000.0f;
                     break;
                 case EStarType::NeutronStar:
-                    star->lifetime += 1000.0f;
+                    cold->lifetime += 1000.0f;
                     break;
                 default:
                     break;
@@ -144,64 +170,325 @@ Star *Star::createStar(Galaxy *galaxy,
 
             break;
         default:
-            if (star->mass < 0.5)
-                star->age = num4 * 0.12f + 0.02f;
-            else if (star->mass < 0.8)
-                star->age = num4 * 0.4f + 0.1f;
+            if (cold->mass < 0.5)
+                cold->age = num4 * 0.12f + 0.02f;
+            else if (cold->mass < 0.8)
+                cold->age = num4 * 0.4f + 0.1f;
             else
-                star->age = num4 * 0.7f + 0.2f;
+                cold->age = num4 * 0.7f + 0.2f;
             break;
     }
 
-    auto num11 = star->lifetime * star->age;
+    auto num11 = cold->lifetime * cold->age;
     if (num11 > 5000.0f) num11 = (std::log(num11 / 5000.0f) + 1.0f) * 5000.0f;
     if (num11 > 8000.0f)
         num11 = (std::log(float(std::log(float(std::log(num11 / 8000.0f) + 1.0f)) + 1.0f)) + 1.0f) * 8000.0f;
-    star->lifetime = num11 / star->age;
-    auto num12 = (1.0f - std::pow(util::clamp01(star->age), 20.0f) * 0.5f) * star->mass;
-    star->temperature = std::pow(num12, 0.56 + 0.14 / (std::log10(num12 + 4.0f) / log10_5)) * 4450.0 + 1300.0;
-    auto num13 = std::log10((star->temperature - 1300.0) / 4500.0) / log10_26 - 0.5;
+    cold->lifetime = num11 / cold->age;
+    auto num12 = (1.0f - std::pow(util::clamp01(cold->age), 20.0f) * 0.5f) * cold->mass;
+    cold->temperature = std::pow(num12, 0.56 + 0.14 / (std::log10(num12 + 4.0f) / log10_5)) * 4450.0 + 1300.0;
+    auto num13 = std::log10((cold->temperature - 1300.0) / 4500.0) / log10_26 - 0.5;
     if (num13 < 0.0) num13 *= 4.0;
     if (num13 > 2.0)
         num13 = 2.0;
     else if (num13 < -4.0) num13 = -4.0;
-    star->spectr = (ESpectrType)(int)std::round(float(num13 + 4.0f));
-    star->color = util::clamp01(float((num13 + 3.5f) * 0.2f));
-    star->luminosity = std::pow(num12, 0.7f);
-    star->radius = std::pow(star->mass, 0.4) * num8;
+    spectr = (ESpectrType)(int)std::round(float(num13 + 4.0f));
+    cold->color = util::clamp01(float((num13 + 3.5f) * 0.2f));
+    luminosity = std::pow(num12, 0.7f);
+    cold->radius = std::pow(cold->mass, 0.4) * num8;
 /*
-    star->acdiskRadius = 0.0f;
+    acdiskRadius = 0.0f;
 */
     auto p = float(num13 + 2.0f);
-    star->habitableRadius = std::pow(1.7f, p) + 0.25f * std::min(1.0f, star->orbitScaler);
-    star->lightBalanceRadius = std::pow(1.7f, p);
-    star->orbitScaler = std::pow(1.35f, p);
-    if (star->orbitScaler < 1.0f) star->orbitScaler = util::lerp(star->orbitScaler, 1.0f, 0.6f);
-    star->setStarAge(rn, rt);
-    star->dysonRadius = star->orbitScaler * 0.28f;
-    auto radMin = star->physicsRadius() * 1.5 / 40000.0;
-    if (star->dysonRadius < radMin)
-        star->dysonRadius = radMin;
-/*
-    star->uPosition = star->position * 2400000.0;
-*/
-    if (settings.genName) {
-        star->name = NameGen::randomStarName(seed2, star, galaxy);
+    cold->habitableRadius = std::pow(1.7f, p) + 0.25f * std::min(1.0f, cold->orbitScaler);
+    cold->lightBalanceRadius = std::pow(1.7f, p);
+    cold->orbitScaler = std::pow(1.35f, p);
+    if (cold->orbitScaler < 1.0f) cold->orbitScaler = util::lerp(cold->orbitScaler, 1.0f, 0.6f);
+    setStarAge(rn, rt);
+    dysonRadius = cold->orbitScaler * 0.28f;
+    auto radMin = physicsRadius() * 1.5 / 40000.0;
+    if (dysonRadius < radMin)
+        dysonRadius = radMin;
+}
+
+static bool sameBits(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+bool Star::samePhysics(const Star *star, const double *draws, EStarType needtype, ESpectrType needSpectr) {
+    StarCold refCold;
+    refCold.level = star->cold->level;
+    Star ref;
+    ref.cold = &refCold;
+    ref.applyPhysics(draws, needtype, needSpectr);
+    const auto *cold = star->cold;
+    return ref.type == star->type && ref.spectr == star->spectr && sameBits(ref.luminosity, star->luminosity)
+        && sameBits(ref.dysonRadius, star->dysonRadius) && sameBits(refCold.mass, cold->mass)
+        && sameBits(refCold.lifetime, cold->lifetime) && sameBits(refCold.age, cold->age)
+        && sameBits(refCold.temperature, cold->temperature) && sameBits(refCold.radius, cold->radius)
+        && sameBits(refCold.habitableRadius, cold->habitableRadius)
+        && sameBits(refCold.lightBalanceRadius, cold->lightBalanceRadius)
+        && sameBits(refCold.orbitScaler, cold->orbitScaler) && sameBits(refCold.color, cold->color);
+}
+
+/* Intermediate values of up to `kLanes` stars built together, one array per value */
+struct StarLanes {
+    static constexpr int kLanes = 16;
+
+    double draws[Star::PhysicsDraws][kLanes];
+    EStarType needtype[kLanes];
+    ESpectrType needSpectr[kLanes];
+    float level[kLanes];
+    double num8[kLanes];
+    float num10[kLanes];
+    float mass[kLanes];
+    float lifetime[kLanes];
+    float age[kLanes];
+    float num12[kLanes];
+    float temperature[kLanes];
+    double num13[kLanes];
+    float luminosity[kLanes];
+    float radius[kLanes];
+    float color[kLanes];
+    ESpectrType spectr[kLanes];
+    float habitableRadius[kLanes];
+    float lightBalanceRadius[kLanes];
+    float orbitScaler[kLanes];
+};
+
+/* applyPhysics() split into stages, each a flat loop over the lanes, so the arithmetic
+ * between calls vectorizes and the libm calls of independent stars overlap.
+ * Every value keeps the type it has in applyPhysics() and goes through the same
+ * std:: functions, which is what keeps the results bit-identical */
+static void starPhysicsLanes(StarLanes &l, int n) {
+    for (int i = 0; i < n; i++) {
+        l.num8[i] = std::pow(2.0, l.draws[7][i] * 0.4 - 0.2);
+    }
+    for (int i = 0; i < n; i++) {
+        auto num7 = l.draws[7][i] * 0.4 - 0.2;
+        auto num9 = util::lerp(-0.98f, 0.88f, l.level[i]);
+        num9 = num9 >= 0.0f ? num9 + 0.65f : num9 - 0.65f;
+        auto standardDeviation = 0.33f;
+        if (l.needtype[i] == EStarType::GiantStar) {
+            num9 = num7 > -0.08 ? -1.5f : 1.6f;
+            standardDeviation = 0.3f;
+        }
+        float num10;
+        switch (l.needSpectr[i]) {
+            case ESpectrType::M:
+                num10 = -3.0f;
+                break;
+            case ESpectrType::O:
+                num10 = 3.0f;
+                break;
+            default:
+                num10 = randNormal(num9, standardDeviation, l.draws[0][i], l.draws[1][i]);
+                break;
+        }
+        l.num10[i] = num10;
+    }
+    for (int i = 0; i < n; i++) {
+        auto num2 = l.draws[0][i];
+        auto num3 = l.draws[1][i];
+        auto num5 = (l.draws[5][i] - 0.5) * 0.2;
+        auto num10 = l.num10[i];
+        num10 = num10 <= 0.0f ? num10 * 1.0f : num10 * 2.0f;
+        num10 = float(std::clamp(num10, -2.4f, 4.65f) + num5 + 1.0f);
+        l.num10[i] = num10;
+        switch (l.needtype[i]) {
+            case EStarType::BlackHole:
+                l.mass[i] = 18.0f + (num2 * num3) * 30.0f;
+                break;
+            case EStarType::NeutronStar:
+                l.mass[i] = 7.0f + num2 * 11.0f;
+                break;
+            case EStarType::WhiteDwarf:
+                l.mass[i] = 1.0f + num3 * 5.0f;
+                break;
+            default:
+                l.mass[i] = 0.0f;
+                break;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        switch (l.needtype[i]) {
+            case EStarType::BlackHole:
+            case EStarType::NeutronStar:
+            case EStarType::WhiteDwarf:
+                break;
+            default:
+                l.mass[i] = std::pow(2.0f, l.num10[i]);
+                break;
+        }
+    }
+    /* Giants only keep the lifetime computed from `mass * 0.58`, skip the other one */
+    for (int i = 0; i < n; i++) {
+        auto mass = l.mass[i];
+        auto num6 = l.draws[6][i] * 0.2 + 0.9;
+        auto d = mass < 2.0f ? (2.0 + 0.4 * (1.0 - mass)) : 5.0;
+        auto factor = l.needtype[i] == EStarType::GiantStar ? 0.58 : 0.5;
+        l.lifetime[i] = 10000.0 * std::pow(0.1, std::log10(mass * factor) / std::log10(d) + 1.0) * num6;
+    }
+    for (int i = 0; i < n; i++) {
+        auto num4 = l.draws[2][i];
+        auto mass = l.mass[i];
+        switch (l.needtype[i]) {
+            case EStarType::GiantStar:
+                l.age[i] = num4 * 0.04f + 0.96f;
+                break;
+            case EStarType::WhiteDwarf:
+                l.age[i] = num4 * 0.4f + 1.0f;
+                l.lifetime[i] += 10000.0f;
+                break;
+            case EStarType::NeutronStar:
+                l.age[i] = num4 * 0.4f + 1.0f;
+                l.lifetime[i] += 1000.0f;
+                break;
+            case EStarType::BlackHole:
+                l.age[i] = num4 * 0.4f + 1.0f;
+                break;
+            default:
+                if (mass < 0.5)
+                    l.age[i] = num4 * 0.12f + 0.02f;
+                else if (mass < 0.8)
+                    l.age[i] = num4 * 0.4f + 0.1f;
+                else
+                    l.age[i] = num4 * 0.7f + 0.2f;
+                break;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        auto num11 = l.lifetime[i] * l.age[i];
+        if (num11 > 5000.0f) num11 = (std::log(num11 / 5000.0f) + 1.0f) * 5000.0f;
+        if (num11 > 8000.0f)
+            num11 = (std::log(float(std::log(float(std::log(num11 / 8000.0f) + 1.0f)) + 1.0f)) + 1.0f) * 8000.0f;
+        l.lifetime[i] = num11 / l.age[i];
+    }
+    for (int i = 0; i < n; i++) {
+        l.num12[i] = (1.0f - std::pow(util::clamp01(l.age[i]), 20.0f) * 0.5f) * l.mass[i];
+    }
+    for (int i = 0; i < n; i++) {
+        auto num12 = l.num12[i];
+        l.temperature[i] = std::pow(num12, 0.56 + 0.14 / (std::log10(num12 + 4.0f) / log10_5)) * 4450.0 + 1300.0;
+    }
+    for (int i = 0; i < n; i++) {
+        auto num13 = std::log10((l.temperature[i] - 1300.0) / 4500.0) / log10_26 - 0.5;
+        if (num13 < 0.0) num13 *= 4.0;
+        if (num13 > 2.0)
+            num13 = 2.0;
+        else if (num13 < -4.0) num13 = -4.0;
+        l.num13[i] = num13;
+        l.spectr[i] = (ESpectrType)(int)std::round(float(num13 + 4.0f));
+        l.color[i] = util::clamp01(float((num13 + 3.5f) * 0.2f));
+    }
+    for (int i = 0; i < n; i++) {
+        l.luminosity[i] = std::pow(l.num12[i], 0.7f);
+        l.radius[i] = std::pow(l.mass[i], 0.4) * l.num8[i];
+    }
+    /* applyPhysics() reads `orbitScaler` for the habitable radius while it is still 1,
+     * so its `0.25f * std::min(1.0f, orbitScaler)` is exactly 0.25f */
+    for (int i = 0; i < n; i++) {
+        auto p = float(l.num13[i] + 2.0f);
+        auto lightBalanceRadius = std::pow(1.7f, p);
+        l.lightBalanceRadius[i] = lightBalanceRadius;
+        l.habitableRadius[i] = lightBalanceRadius + 0.25f;
+        auto orbitScaler = std::pow(1.35f, p);
+        if (orbitScaler < 1.0f) orbitScaler = util::lerp(orbitScaler, 1.0f, 0.6f);
+        l.orbitScaler[i] = orbitScaler;
     }
-    return star;
 }
 
-Star *Star::createBirthStar(Galaxy *galaxy, int seed) {
-    static const auto log10_26 = std::log10(2.6);
-    static const auto log10_5 = std::log10(5.0);
+template<bool GenName>
+void Star::createStars(Galaxy *galaxy, int first, int count, const VectorLF3 *poses, const int *seeds,
+                       const int *seeds2, const int *planetSeeds, util::DotNet35Random *rands,
+                       const EStarType *needtypes, const ESpectrType *needSpectrs) {
+    StarLanes lanes;
+    auto end = first + count;
+    for (int base = first; base < end; base += StarLanes::kLanes) {
+        auto n = std::min(StarLanes::kLanes, end - base);
+        for (int i = 0; i < n; i++) {
+            auto index = base + i;
+            auto *star = galaxy->stars[index];
+            star->galaxy = galaxy;
+            star->index = index;
+            if (galaxy->starCount > 1)
+                star->cold->level = float(index) / float(galaxy->starCount - 1);
+            else
+                star->cold->level = 0.0f;
+            star->id = index + 1;
+            star->cold->seed = seeds[index];
+            star->cold->planetSeed = planetSeeds[index];
+            if (poses) star->position = poses[index];
+            lanes.level[i] = star->cold->level;
+            lanes.needtype[i] = needtypes[index];
+            lanes.needSpectr[i] = needSpectrs[index];
+            auto &rand = rands[index];
+            for (auto &draw: lanes.draws) draw[i] = rand.nextDouble();
+        }
+        starPhysicsLanes(lanes, n);
+        for (int i = 0; i < n; i++) {
+            auto *star = galaxy->stars[base + i];
+            auto *cold = star->cold;
+            cold->mass = lanes.mass[i];
+            cold->lifetime = lanes.lifetime[i];
+            cold->age = lanes.age[i];
+            cold->temperature = lanes.temperature[i];
+            star->spectr = lanes.spectr[i];
+            cold->color = lanes.color[i];
+            star->luminosity = lanes.luminosity[i];
+            cold->radius = lanes.radius[i];
+            cold->habitableRadius = lanes.habitableRadius[i];
+            cold->lightBalanceRadius = lanes.lightBalanceRadius[i];
+            cold->orbitScaler = lanes.orbitScaler[i];
+            star->setStarAge(lanes.draws[3][i], lanes.draws[4][i]);
+            star->dysonRadius = cold->orbitScaler * 0.28f;
+            auto radMin = star->physicsRadius() * 1.5 / 40000.0;
+            if (star->dysonRadius < radMin)
+                star->dysonRadius = radMin;
+#if defined(DSPUGEN_STAR_PHYSICS_CHECK)
+            double draws[PhysicsDraws];
+            for (int k = 0; k < PhysicsDraws; k++) draws[k] = lanes.draws[k][i];
+            if (!samePhysics(star, draws, lanes.needtype[i], lanes.needSpectr[i])) {
+                fprintf(stderr, "Batched star physics differs from the scalar path: seed %d, star %d\n",
+                        galaxy->seed, star->id);
+                std::abort();
+            }
+#endif
+        }
+    }
+    if constexpr (GenName) {
+        for (int index = first; index < end; index++) {
+            NameGen::randomStarName(seeds2[index], galaxy->stars[index], galaxy);
+        }
+    }
+}
 
-    auto star = spool->alloc();
-    star->galaxy = galaxy;
-    star->seed = seed;
+template void Star::createStars<false>(Galaxy *, int, int, const VectorLF3 *, const int *, const int *, const int *,
+                                       util::DotNet35Random *, const EStarType *, const ESpectrType *);
+template void Star::createStars<true>(Galaxy *, int, int, const VectorLF3 *, const int *, const int *, const int *,
+                                      util::DotNet35Random *, const EStarType *, const ESpectrType *);
+
+Star *Star::createBirthStar(GenContext &ctx, Galaxy *galaxy, int seed) {
     util::DotNet35Random dotNet35Random(seed);
     auto seed2 = dotNet35Random.next();
     auto seed3 = dotNet35Random.next();
+    dotNet35Random.next();
+    auto planetSeed = dotNet35Random.next();
     util::DotNet35Random dotNet35Random2(seed3);
+    if (ctx.settings.genName)
+        return createBirthStar<true>(galaxy, seed, seed2, planetSeed, dotNet35Random2);
+    return createBirthStar<false>(galaxy, seed, seed2, planetSeed, dotNet35Random2);
+}
+
+template<bool GenName>
+Star *Star::createBirthStar(Galaxy *galaxy, int seed, int seed2, int planetSeed,
+                            util::DotNet35Random &dotNet35Random2) {
+    static const auto log10_26 = std::log10(2.6);
+    static const auto log10_5 = std::log10(5.0);
+
+    auto *star = galaxy->stars[0];
+    star->galaxy = galaxy;
+    star->cold->seed = seed;
+    star->cold->planetSeed = planetSeed;
     auto r = dotNet35Random2.nextDouble();
     auto r2 = dotNet35Random2.nextDouble();
     auto num = dotNet35Random2.nextDouble();
@@ -212,109 +499,121 @@ Star *Star::createBirthStar(Galaxy *galaxy, int seed) {
     auto num3 = std::pow(2.0, y);
     auto value = randNormal(0.0f, 0.08f, r, r2);
     value = std::clamp(value, -0.2f, 0.2f);
-    star->mass = std::pow(2.0f, value);
-    auto num4 = 2.0 + 0.4 * (1.0 - star->mass);
-    star->lifetime = 10000.0 * std::pow(0.1, std::log10(star->mass * 0.5) / std::log10(num4) + 1.0) * num2;
-    star->age = float(num * 0.4 + 0.3);
-    auto num5 = (1.0f - std::pow(std::clamp(star->age, 0.0f, 1.0f), 20.0f) * 0.5f) * star->mass;
-    star->temperature = std::pow(num5, 0.56 + 0.14 / (std::log10((double)(num5 + 4.0f)) / log10_5)) * 4450.0 + 1300.0;
-    auto num6 = std::log10((star->temperature - 1300.0) / 4500.0) / log10_26 - 0.5;
+    star->cold->mass = std::pow(2.0f, value);
+    auto num4 = 2.0 + 0.4 * (1.0 - star->cold->mass);
+    star->cold->lifetime = 10000.0 * std::pow(0.1, std::log10(star->cold->mass * 0.5) / std::log10(num4) + 1.0) * num2;
+    star->cold->age = float(num * 0.4 + 0.3);
+    auto num5 = (1.0f - std::pow(std::clamp(star->cold->age, 0.0f, 1.0f), 20.0f) * 0.5f) * star->cold->mass;
+    star->cold->temperature = std::pow(num5, 0.56 + 0.14 / (std::log10((double)(num5 + 4.0f)) / log10_5)) * 4450.0 + 1300.0;
+    auto num6 = std::log10((star->cold->temperature - 1300.0) / 4500.0) / log10_26 - 0.5;
     if (num6 < 0.0) num6 *= 4.0;
     if (num6 > 2.0)
         num6 = 2.0;
     else if (num6 < -4.0) num6 = -4.0;
     star->spectr = (ESpectrType)(int)std::round(float(num6 + 4.0f));
-    star->color = util::clamp01(float((num6 + 3.5f) * 0.2f));
+    star->cold->color = util::clamp01(float((num6 + 3.5f) * 0.2f));
     star->luminosity = std::pow(num5, 0.7f);
-    star->radius = std::pow(star->mass, 0.4) * num3;
+    star->cold->radius = std::pow(star->cold->mass, 0.4) * num3;
 /*
     star->acdiskRadius = 0.0f;
 */
     auto p = float(num6 + 2.0f);
-    star->habitableRadius = std::pow(1.7f, p) + 0.2f * std::min(1.0f, star->orbitScaler);
-    star->lightBalanceRadius = std::pow(1.7f, p);
-    star->orbitScaler = std::pow(1.35f, p);
-    if (star->orbitScaler < 1.0f) star->orbitScaler = util::lerp(star->orbitScaler, 1.0f, 0.6f);
+    star->cold->habitableRadius = std::pow(1.7f, p) + 0.2f * std::min(1.0f, star->cold->orbitScaler);
+    star->cold->lightBalanceRadius = std::pow(1.7f, p);
+    star->cold->orbitScaler = std::pow(1.35f, p);
+    if (star->cold->orbitScaler < 1.0f) star->cold->orbitScaler = util::lerp(star->cold->orbitScaler, 1.0f, 0.6f);
     star->setStarAge(rn, rt);
-    star->dysonRadius = star->orbitScaler * 0.28f;
+    star->dysonRadius = star->cold->orbitScaler * 0.28f;
     if (star->dysonRadius * 40000.0f < star->physicsRadius() * 1.5f)
         star->dysonRadius = star->physicsRadius() * 1.5f / 40000.0f;
-    if (settings.genName) {
-        star->name = NameGen::randomStarName(seed2, star, galaxy);
+    if constexpr (GenName) {
+        NameGen::randomStarName(seed2, star, galaxy);
     }
     return star;
 }
 
+template Star *Star::createBirthStar<false>(Galaxy *, int, int, int, util::DotNet35Random &);
+template Star *Star::createBirthStar<true>(Galaxy *, int, int, int, util::DotNet35Random &);
+
 void Star::setStarAge(double rn, double rt) {
     auto num = float(rn * 0.1 + 0.95);
     auto num2 = float(rt * 0.4 + 0.8);
     auto num3 = float(rt * 9.0 + 1.0);
-    if (age >= 1.0f) {
-        if (mass >= 18.0f) {
+    if (cold->age >= 1.0f) {
+        if (cold->mass >= 18.0f) {
             type = EStarType::BlackHole;
             spectr = ESpectrType::X;
-            mass *= 2.5f * num2;
-            radius *= 1.0f;
+            cold->mass *= 2.5f * num2;
+            cold->radius *= 1.0f;
 /*
-            acdiskRadius = radius * 5.0f;
+            acdiskRadius = cold->radius * 5.0f;
 */
-            temperature = 0.0f;
+            cold->temperature = 0.0f;
             luminosity *= 0.001f * num;
-            habitableRadius = 0.0f;
-            lightBalanceRadius *= 0.4f * num;
-            color = 1.0f;
-        } else if (mass >= 7.0f) {
+            cold->habitableRadius = 0.0f;
+            cold->lightBalanceRadius *= 0.4f * num;
+            cold->color = 1.0f;
+        } else if (cold->mass >= 7.0f) {
             type = EStarType::NeutronStar;
             spectr = ESpectrType::X;
-            mass *= 0.2f * num;
-            radius *= 0.15f;
+            cold->mass *= 0.2f * num;
+            cold->radius *= 0.15f;
 /*
-            acdiskRadius = radius * 9.0f;
+            acdiskRadius = cold->radius * 9.0f;
 */
-            temperature = num3 * 1E+07f;
+            cold->temperature = num3 * 1E+07f;
             luminosity *= 0.1f * num;
-            habitableRadius = 0.0f;
-            lightBalanceRadius *= 3.0f * num;
-            orbitScaler *= 1.5f * num;
-            color = 1.0f;
+            cold->habitableRadius = 0.0f;
+            cold->lightBalanceRadius *= 3.0f * num;
+            cold->orbitScaler *= 1.5f * num;
+            cold->color = 1.0f;
         } else {
             type = EStarType::WhiteDwarf;
             spectr = ESpectrType::X;
-            mass *= 0.2f * num;
-            radius *= 0.2f;
+            cold->mass *= 0.2f * num;
+            cold->radius *= 0.2f;
 /*
             acdiskRadius = 0.0f;
 */
-            temperature = num2 * 150000.0f;
+            cold->temperature = num2 * 150000.0f;
             luminosity *= 0.04f * num2;
-            habitableRadius *= 0.15f * num2;
-            lightBalanceRadius *= 0.2f * num;
-            color = 0.7f;
+            cold->habitableRadius *= 0.15f * num2;
+            cold->lightBalanceRadius *= 0.2f * num;
+            cold->color = 0.7f;
         }
-    } else if (age >= 0.96f) {
-        auto num4 = float(std::pow(5.0, std::abs(std::log10(mass) - 0.7)) * 5.0);
+    } else if (cold->age >= 0.96f) {
+        auto num4 = float(std::pow(5.0, std::abs(std::log10(cold->mass) - 0.7)) * 5.0);
         if (num4 > 10.0f) num4 = (std::log(num4 * 0.1f) + 1.0f) * 10.0f;
-        auto num5 = 1.0f - std::pow(age, 30.0f) * 0.5f;
+        auto num5 = 1.0f - std::pow(cold->age, 30.0f) * 0.5f;
         type = EStarType::GiantStar;
-        mass = num5 * mass;
-        radius = num4 * num2;
+        cold->mass = num5 * cold->mass;
+        cold->radius = num4 * num2;
 /*
         acdiskRadius = 0.0f;
 */
-        temperature = num5 * temperature;
+        cold->temperature = num5 * cold->temperature;
         luminosity = 1.6f * luminosity;
-        habitableRadius = 9.0f * habitableRadius;
-        lightBalanceRadius = 3.0f * habitableRadius;
-        orbitScaler = 3.3f * orbitScaler;
+        cold->habitableRadius = 9.0f * cold->habitableRadius;
+        cold->lightBalanceRadius = 3.0f * cold->habitableRadius;
+        cold->orbitScaler = 3.3f * cold->orbitScaler;
+    }
+}
+
+void Star::allocPlanets(int count) {
+    auto &arena = galaxy->arena;
+    auto &planets = cold->planets;
+    planets.resize(arena, count);
+    auto *hot = arena.allocArray<Planet>(count);
+    auto *colds = arena.allocArray<PlanetCold>(count);
+    for (int i = 0; i < count; i++) {
+        planets[i] = new(hot + i) Planet();
+        hot[i].cold = new(colds + i) PlanetCold();
     }
 }
 
 void Star::createStarPlanets() {
-    util::DotNet35Random dotNet35Random(seed);
-    dotNet35Random.next();
-    dotNet35Random.next();
-    dotNet35Random.next();
-    util::DotNet35Random dotNet35Random2(dotNet35Random.next());
+    auto &planets = cold->planets;
+    util::DotNet35Random dotNet35Random2(cold->planetSeed);
     auto num = dotNet35Random2.nextDouble();
     auto num2 = dotNet35Random2.nextDouble();
     auto num3 = dotNet35Random2.nextDouble();
@@ -325,26 +624,26 @@ void Star::createStarPlanets() {
     // int planetCount;
     if (type == EStarType::BlackHole) {
         // planetCount = 1;
-        planets.resize(1);
+        allocPlanets(1);
         auto infoSeed = dotNet35Random2.next();
         auto genSeed = dotNet35Random2.next();
         planets[0] = Planet::create(this, 0, 0, 3, 1, false, infoSeed, genSeed);
     } else if (type == EStarType::NeutronStar) {
         // planetCount = 1;
-        planets.resize(1);
+        allocPlanets(1);
         auto infoSeed2 = dotNet35Random2.next();
         auto genSeed2 = dotNet35Random2.next();
         planets[0] = Planet::create(this, 0, 0, 3, 1, false, infoSeed2, genSeed2);
     } else if (type == EStarType::WhiteDwarf) {
         if (num < 0.699999988079071) {
             // planetCount = 1;
-            planets.resize(1);
+            allocPlanets(1);
             auto infoSeed3 = dotNet35Random2.next();
             auto genSeed3 = dotNet35Random2.next();
             planets[0] = Planet::create(this, 0, 0, 3, 1, false, infoSeed3, genSeed3);
         } else {
             // planetCount = 2;
-            planets.resize(2);
+            allocPlanets(2);
             int num8;
             int num9;
             if (num2 < 0.30000001192092896) {
@@ -370,14 +669,14 @@ void Star::createStarPlanets() {
     } else if (type == EStarType::GiantStar) {
         if (num < 0.30000001192092896) {
             // planetCount = 1;
-            planets.resize(1);
+            allocPlanets(1);
             auto infoSeed4 = dotNet35Random2.next();
             auto genSeed4 = dotNet35Random2.next();
             planets[0] = Planet::create(this, 0, 0,
                                         num3 > 0.5 ? 3 : 2, 1, false, infoSeed4, genSeed4);
         } else if (num < 0.800000011920929) {
             // planetCount = 2;
-            planets.resize(2);
+            allocPlanets(2);
             if (num2 < 0.25) {
                 auto num10 = dotNet35Random2.next();
                 auto num11 = dotNet35Random2.next();
@@ -399,7 +698,7 @@ void Star::createStarPlanets() {
             }
         } else {
             // planetCount = 3;
-            planets.resize(3);
+            allocPlanets(3);
             if (num2 < 0.15000000596046448) {
                 auto num12 = dotNet35Random2.next();
                 auto num13 = dotNet35Random2.next();
@@ -563,7 +862,7 @@ void Star::createStarPlanets() {
             planetCount = 1;
         }
 
-        planets.resize(planetCount);
+        allocPlanets(planetCount);
         auto num14 = 0;
         auto num15 = 0;
         auto num16 = 0;
@@ -652,7 +951,7 @@ void Star::createStarPlanets() {
 }
 
 float Star::updateResourceCoef() {
-    if (resourceCoef == 0.0f) {
+    if (cold->resourceCoef == 0.0f) {
         auto distanceFactor = float(position.magnitude() / 32.0f);
         if (distanceFactor > 1.0f) {
             distanceFactor = std::log(distanceFactor) + 1.0f;
@@ -661,9 +960,9 @@ float Star::updateResourceCoef() {
             distanceFactor = std::log(distanceFactor) + 1.0f;
             distanceFactor = std::log(distanceFactor) + 1.0f;
         }
-        resourceCoef = std::pow(7.0f, distanceFactor) * 0.6f;
+        cold->resourceCoef = std::pow(7.0f, distanceFactor) * 0.6f;
     }
-    return resourceCoef;
+    return cold->resourceCoef;
 }
 
 const char *Star::typeName() const {
@@ -10,13 +10,18 @@
 
 #include "planet.hh"
 #include "vectors.hh"
+#include "util/arena.hh"
+#include "util/dotnet35random.hh"
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 
 namespace dspugen {
 
 class Galaxy;
+class GenContext;
 
 enum class EStarType {
     MainSeqStar,
@@ -37,37 +42,24 @@ enum class ESpectrType {
     X
 };
 
-class Star {
-public:
-    static void initThread();
-    static void releaseThread();
-
-    ~Star();
-    void release();
-
-    static constexpr float kPhysicsRadiusRatio = 1200.0f;
-
-    Galaxy *galaxy = nullptr;
-    int index = 0;
+/* Star fields used while generating or read once per star, kept out of the cache
+ * line scanned by filters */
+struct StarCold {
     float level = 0;
-    int id = 1;
     int seed = 0;
-
-    EStarType type = EStarType::MainSeqStar;
-    ESpectrType spectr = ESpectrType::M;
+    /* 4th draw of the generator seeded with `seed`, taken at star creation so
+     * createStarPlanets() does not have to rebuild that generator */
+    int planetSeed = 0;
 
     float mass = 1.0f;
     float lifetime = 50.0f;
     float age;
     float temperature = 8500.0f;
-    float luminosity = 1.0f;
     float radius = 1.0f;
     float habitableRadius = 1.0f;
     float lightBalanceRadius = 1.0f;
     float orbitScaler = 1.0f;
-    float dysonRadius = 10.0f;
 
-    VectorLF3 position;
     float color;
 /*
     float classFactor;
@@ -79,19 +71,85 @@ public:
     float asterBelt1OrbitIndex;
     float asterBelt2OrbitIndex;
 */
-    std::vector<Planet*> planets;
-    std::string name;
+    util::ArenaArray<Planet *> planets;
+    /* Longest generated name is 23 bytes, "180 Trianguli Australis" */
+    static constexpr size_t kNameCapacity = 32;
+    char name[kNameCapacity] = {};
+    uint8_t nameLength = 0;
+};
 
-    static Star *createStar(Galaxy *galaxy, const VectorLF3 &pos, int id, int seed, EStarType needtype,
-                                ESpectrType needSpectr = ESpectrType::X);
-    static Star *createBirthStar(Galaxy *galaxy, int seed);
+/* Hot part of a star, one cache line holding what filters test per star.
+ * The rest is in `cold` and read through the accessors below */
+class alignas(64) Star {
+public:
+    static constexpr float kPhysicsRadiusRatio = 1200.0f;
+
+    Galaxy *galaxy = nullptr;
+    StarCold *cold = nullptr;
+    VectorLF3 position;
+    int index = 0;
+    int id = 1;
+
+    EStarType type = EStarType::MainSeqStar;
+    ESpectrType spectr = ESpectrType::M;
+    float luminosity = 1.0f;
+    float dysonRadius = 10.0f;
+
+    [[nodiscard]] inline const util::ArenaArray<Planet *> &planets() const { return cold->planets; }
+    /* NUL-terminated, empty unless names are generated */
+    [[nodiscard]] inline std::string_view name() const { return {cold->name, cold->nameLength}; }
+    [[nodiscard]] inline int seed() const { return cold->seed; }
+    [[nodiscard]] inline float level() const { return cold->level; }
+    [[nodiscard]] inline float mass() const { return cold->mass; }
+    [[nodiscard]] inline float lifetime() const { return cold->lifetime; }
+    [[nodiscard]] inline float age() const { return cold->age; }
+    [[nodiscard]] inline float temperature() const { return cold->temperature; }
+    [[nodiscard]] inline float radius() const { return cold->radius; }
+    [[nodiscard]] inline float habitableRadius() const { return cold->habitableRadius; }
+    [[nodiscard]] inline float lightBalanceRadius() const { return cold->lightBalanceRadius; }
+    [[nodiscard]] inline float orbitScaler() const { return cold->orbitScaler; }
+    [[nodiscard]] inline float color() const { return cold->color; }
+    [[nodiscard]] inline float resourceCoef() const { return cold->resourceCoef; }
+
+    /* All creators fill `galaxy->stars[id - 1]`, laid out by the galaxy beforehand */
+    static Star *createStar(GenContext &ctx, Galaxy *galaxy, const VectorLF3 &pos, int id, int seed,
+                            EStarType needtype, ESpectrType needSpectr = ESpectrType::X);
+    /* `seed2` and `planetSeed` are the 1st and 4th draw of a generator seeded with `seed`,
+     * `dotNet35Random2` is seeded with its 2nd draw, for callers seeding them in bulk.
+     * `GenName` replaces the runtime `ctx.settings.genName` test of the overloads above */
+    template<bool GenName>
+    static Star *createStar(Galaxy *galaxy, const VectorLF3 &pos, int id, int seed, int seed2, int planetSeed,
+                            util::DotNet35Random &dotNet35Random2, EStarType needtype, ESpectrType needSpectr);
+    /* Batched createStar() for the stars at indices `first` to `first + count - 1`, the
+     * arrays are indexed by star index. Physics of up to 16 stars run side by side,
+     * with results bit-identical to createStar(). `poses` may be null to keep the default */
+    template<bool GenName>
+    static void createStars(Galaxy *galaxy, int first, int count, const VectorLF3 *poses, const int *seeds,
+                            const int *seeds2, const int *planetSeeds, util::DotNet35Random *rands,
+                            const EStarType *needtypes, const ESpectrType *needSpectrs);
+    static Star *createBirthStar(GenContext &ctx, Galaxy *galaxy, int seed);
+    template<bool GenName>
+    static Star *createBirthStar(Galaxy *galaxy, int seed, int seed2, int planetSeed,
+                                 util::DotNet35Random &dotNet35Random2);
+    /* Go through Galaxy::createPlanets(), which keeps stars in order */
     void createStarPlanets();
     [[nodiscard]] const char *typeName() const;
-    [[nodiscard]] inline float physicsRadius() const { return radius * kPhysicsRadiusRatio; }
+    [[nodiscard]] inline float physicsRadius() const { return cold->radius * kPhysicsRadiusRatio; }
     [[nodiscard]] float updateResourceCoef();
 
+    /* Uniform draws taken by applyPhysics() from the second star generator */
+    static constexpr int PhysicsDraws = 8;
+    /* Whether a star built by createStars() matches, bit for bit, the scalar physics of
+     * createStar() run again on the same draws. Used by the starcheck tool and by
+     * STAR_PHYSICS_CHECK builds */
+    static bool samePhysics(const Star *star, const double *draws, EStarType needtype, ESpectrType needSpectr);
+
 private:
     void setStarAge(double rn, double rt);
+    void applyPhysics(const double *draws, EStarType needtype, ESpectrType needSpectr);
+    /* Planets of a star and their cold parts are laid out next to each other,
+     * Planet::create() fills these slots */
+    void allocPlanets(int count);
 };
 
 }
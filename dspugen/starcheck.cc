@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+/* Checks the batched star physics of Star::createStars() against the scalar path of
+ * createStar(), bit for bit, over fixed seeds, star counts and every required type and
+ * spectrum, and that galaxy skeletons of small star counts hold together. Exits with 1
+ * on any difference.
+ * Usage: starcheck */
+
+#include "galaxy.hh"
+#include "galaxyskeleton.hh"
+#include "star.hh"
+#include "util/dotnet35random.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+using namespace dspugen;
+
+static constexpr int Seeds[] = {0, 1, 42, 65535, 1000000, 99999999, INT32_MAX};
+/* Around the lane count of the kernel, so partial batches are covered */
+static constexpr int StarCounts[] = {1, 2, 5, 15, 16, 17, 31, 32, 33, 48, 64};
+/* Skeletons are built for every count up to this, small ones have no giant period */
+static constexpr int MaxSkeletonCount = 64;
+static constexpr int StarTypes = static_cast<int>(EStarType::BlackHole) + 1;
+static constexpr int SpectrTypes = static_cast<int>(ESpectrType::X) + 1;
+
+/* Builds stars 1 to `starCount - 1` (all of them for a single star) with the batched
+ * kernel and returns how many differ from the scalar physics */
+static int checkGalaxy(int seed, int starCount, EStarType needtype, ESpectrType needSpectr) {
+    auto stars = std::make_unique<Star[]>(starCount);
+    auto colds = std::make_unique<StarCold[]>(starCount);
+    std::vector<Star *> slots(starCount);
+    for (int i = 0; i < starCount; i++) {
+        stars[i].cold = &colds[i];
+        slots[i] = &stars[i];
+    }
+    Galaxy galaxy;
+    galaxy.seed = seed;
+    galaxy.starCount = starCount;
+    galaxy.stars.attach(slots.data(), slots.size());
+
+    std::vector<int> seeds(starCount), seeds2(starCount), planetSeeds(starCount);
+    std::vector<util::DotNet35Random> rands;
+    rands.reserve(starCount);
+    util::DotNet35Random gen(seed ^ starCount * 7919 ^ static_cast<int>(needtype) << 16 ^ static_cast<int>(needSpectr) << 20);
+    for (int i = 0; i < starCount; i++) {
+        seeds[i] = gen.next();
+        seeds2[i] = gen.next();
+        planetSeeds[i] = gen.next();
+        rands.emplace_back(gen.next());
+    }
+    /* The kernel draws from `rands`, the copies give the same draws to the scalar path */
+    auto drawRands = rands;
+    std::vector<EStarType> needtypes(starCount, needtype);
+    std::vector<ESpectrType> needSpectrs(starCount, needSpectr);
+
+    auto first = starCount > 1 ? 1 : 0;
+    Star::createStars<false>(&galaxy, first, starCount - first, nullptr, seeds.data(), seeds2.data(),
+                             planetSeeds.data(), rands.data(), needtypes.data(), needSpectrs.data());
+
+    int failed = 0;
+    for (int i = first; i < starCount; i++) {
+        double draws[Star::PhysicsDraws];
+        for (auto &draw: draws) draw = drawRands[i].nextDouble();
+        if (!Star::samePhysics(slots[i], draws, needtype, needSpectr)) {
+            fprintf(stderr, "Star physics differs: seed %d, star count %d, star %d, type %d, spectrum %d\n",
+                    seed, starCount, i + 1, static_cast<int>(needtype), static_cast<int>(needSpectr));
+            failed++;
+        }
+    }
+    galaxy.stars.clear();
+    return failed;
+}
+
+/* Builds the skeleton of each seed and star count and returns how many have type
+ * counts that do not add up to the star count */
+static int checkSkeletons() {
+    int failed = 0;
+    for (auto seed: Seeds) {
+        for (int starCount = 1; starCount <= MaxSkeletonCount; starCount++) {
+            util::DotNet35Random gen(seed);
+            gen.next();
+            GalaxySkeleton skeleton;
+            skeleton.build(seed, starCount, gen);
+            auto total = skeleton.mainSeqCount + skeleton.giantCount + skeleton.whiteDwarfCount
+                + skeleton.neutronStarCount + skeleton.blackHoleCount;
+            if (total != starCount) {
+                fprintf(stderr, "Skeleton type counts differ: seed %d, star count %d, total %d\n", seed, starCount, total);
+                failed++;
+            }
+        }
+    }
+    return failed;
+}
+
+int main() {
+    auto skeletonsFailed = checkSkeletons();
+    int checked = 0, failed = 0;
+    for (auto seed: Seeds) {
+        for (auto starCount: StarCounts) {
+            for (int type = 0; type < StarTypes; type++) {
+                for (int spectr = 0; spectr < SpectrTypes; spectr++) {
+                    failed += checkGalaxy(seed, starCount, static_cast<EStarType>(type), static_cast<ESpectrType>(spectr));
+                    checked += starCount > 1 ? starCount - 1 : 1;
+                }
+            }
+        }
+    }
+    printf("%d stars checked, %d differ\n", checked, failed);
+    printf("%d skeletons checked, %d differ\n", int(std::size(Seeds)) * MaxSkeletonCount, skeletonsFailed);
+    return failed > 0 || skeletonsFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace dspugen::util {
+
+#if defined(DSPUGEN_ALLOC_CHECK)
+/* Heap allocations made by the current thread. Counted by arena blocks taken from
+ * malloc, and by the operator new replacement of the executable */
+inline thread_local uint64_t heapAllocCount = 0;
+#endif
+
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+#pragma once
+
+#include "alloccount.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+namespace dspugen::util {
+
+struct ArenaBlock {
+    ArenaBlock *next;
+    size_t size;
+
+    [[nodiscard]] inline char *data() { return reinterpret_cast<char *>(this + 1); }
+};
+
+/* Free list of arena blocks owned by one thread. Blocks of the default size are
+ * recycled, larger ones are only made for single oversized allocations */
+class ArenaBlockPool final {
+public:
+    /* A whole 64-star galaxy with planets and gas fits in one block,
+     * so a thread settles on a single block after its first galaxy */
+    static constexpr size_t BlockSize = 256 * 1024 - sizeof(ArenaBlock);
+
+    ArenaBlockPool() = default;
+    ArenaBlockPool(const ArenaBlockPool &) = delete;
+    ArenaBlockPool &operator=(const ArenaBlockPool &) = delete;
+    ~ArenaBlockPool() {
+        freeChain(free_);
+    }
+
+    ArenaBlock *acquire(size_t size) {
+        if (size <= BlockSize && free_) {
+            auto *block = free_;
+            free_ = block->next;
+            block->next = nullptr;
+            return block;
+        }
+        size = std::max(size, BlockSize);
+#if defined(DSPUGEN_ALLOC_CHECK)
+        ++heapAllocCount;
+#endif
+        auto *block = static_cast<ArenaBlock *>(malloc(sizeof(ArenaBlock) + size));
+        if (!block) throw std::bad_alloc();
+        block->next = nullptr;
+        block->size = size;
+        return block;
+    }
+
+    /* Give back a chain of default sized blocks from `head` to `tail` */
+    void recycle(ArenaBlock *head, ArenaBlock *tail) {
+        tail->next = free_;
+        free_ = head;
+    }
+
+    static void freeChain(ArenaBlock *block) {
+        while (block) {
+            auto *next = block->next;
+            free(block);
+            block = next;
+        }
+    }
+
+private:
+    ArenaBlock *free_ = nullptr;
+};
+
+/* Bump allocator over pooled blocks. Nothing is freed one by one,
+ * reset() hands all blocks back to the pool at once and does not run destructors */
+class Arena final {
+public:
+    Arena() = default;
+    explicit Arena(ArenaBlockPool *pool) noexcept: pool_(pool) {}
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    Arena(Arena &&other) noexcept { take(other); }
+    Arena &operator=(Arena &&other) noexcept {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+    ~Arena() { reset(); }
+
+    void *alloc(size_t size, size_t align) {
+        auto addr = (reinterpret_cast<uintptr_t>(cur_) + align - 1) & ~(uintptr_t(align) - 1);
+        if (addr + size > reinterpret_cast<uintptr_t>(end_)) return allocSlow(size, align);
+        cur_ = reinterpret_cast<char *>(addr + size);
+        return reinterpret_cast<void *>(addr);
+    }
+
+    template<typename T, typename...V>
+    T *create(const V &...v) {
+        return new(alloc(sizeof(T), alignof(T))) T(v...);
+    }
+
+    /* Uninitialized storage for `count` objects of `T` */
+    template<typename T>
+    T *allocArray(size_t count) {
+        return static_cast<T *>(alloc(sizeof(T) * count, alignof(T)));
+    }
+
+    void reset() {
+        if (head_) {
+            pool_->recycle(head_, tail_);
+            head_ = tail_ = nullptr;
+        }
+        if (large_) {
+            ArenaBlockPool::freeChain(large_);
+            large_ = nullptr;
+        }
+        cur_ = end_ = nullptr;
+    }
+
+private:
+    void *allocSlow(size_t size, size_t align) {
+        auto need = size + align;
+        if (need > ArenaBlockPool::BlockSize) {
+            auto *block = pool_->acquire(need);
+            block->next = large_;
+            large_ = block;
+            auto addr = (reinterpret_cast<uintptr_t>(block->data()) + align - 1) & ~(uintptr_t(align) - 1);
+            return reinterpret_cast<void *>(addr);
+        }
+        auto *block = pool_->acquire(need);
+        if (head_) {
+            block->next = head_;
+        } else {
+            tail_ = block;
+        }
+        head_ = block;
+        cur_ = block->data();
+        end_ = cur_ + block->size;
+        return alloc(size, align);
+    }
+
+    void take(Arena &other) {
+        pool_ = other.pool_;
+        head_ = other.head_;
+        tail_ = other.tail_;
+        large_ = other.large_;
+        cur_ = other.cur_;
+        end_ = other.end_;
+        other.head_ = other.tail_ = other.large_ = nullptr;
+        other.cur_ = other.end_ = nullptr;
+    }
+
+    ArenaBlockPool *pool_ = nullptr;
+    /* Default sized blocks, newest first */
+    ArenaBlock *head_ = nullptr;
+    ArenaBlock *tail_ = nullptr;
+    ArenaBlock *large_ = nullptr;
+    char *cur_ = nullptr;
+    char *end_ = nullptr;
+};
+
+/* Fixed size array living in an Arena, with the read interface of std::vector.
+ * Only for trivially copyable types, as arena memory is dropped without destructors */
+template<typename T>
+class ArenaArray final {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>);
+
+public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    /* Replace the content with `count` value-initialized elements */
+    void resize(Arena &arena, size_t count) {
+        data_ = arena.allocArray<T>(count);
+        size_ = count;
+        std::fill(data_, data_ + count, T());
+    }
+    void assign(Arena &arena, const T *src, size_t count) {
+        data_ = arena.allocArray<T>(count);
+        size_ = count;
+        std::copy(src, src + count, data_);
+    }
+    /* Point at `count` elements already allocated from the same arena */
+    void attach(T *data, size_t count) {
+        data_ = data;
+        size_ = count;
+    }
+    void clear() {
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    [[nodiscard]] inline size_t size() const { return size_; }
+    [[nodiscard]] inline bool empty() const { return size_ == 0; }
+    [[nodiscard]] inline T *data() { return data_; }
+    [[nodiscard]] inline const T *data() const { return data_; }
+    [[nodiscard]] inline T *begin() { return data_; }
+    [[nodiscard]] inline T *end() { return data_ + size_; }
+    [[nodiscard]] inline const T *begin() const { return data_; }
+    [[nodiscard]] inline const T *end() const { return data_ + size_; }
+    [[nodiscard]] inline T &operator[](size_t index) { return data_[index]; }
+    [[nodiscard]] inline const T &operator[](size_t index) const { return data_[index]; }
+    [[nodiscard]] inline T &front() { return data_[0]; }
+    [[nodiscard]] inline const T &front() const { return data_[0]; }
+    [[nodiscard]] inline T &back() { return data_[size_ - 1]; }
+    [[nodiscard]] inline const T &back() const { return data_[size_ - 1]; }
+
+private:
+    T *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}
@@ -9,10 +9,20 @@
 #include "dotnet35random.hh"
 
 #include <cmath>
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 namespace dspugen::util {
 
+#if defined(DSPUGEN_RNG_STATS)
+thread_local uint64_t DotNet35Random::initCount = 0;
+#endif
+
 DotNet35Random::DotNet35Random(int seed) {
+#if defined(DSPUGEN_RNG_STATS)
+    ++initCount;
+#endif
     int num = 161803398 - std::abs(seed);
     seedArray[55] = num;
     int num2 = 1;
@@ -31,4 +41,89 @@ DotNet35Random::DotNet35Random(int seed) {
         }
 }
 
+/* The lane kernels below run the constructor above on a transposed seed array
+ * (`arr[k]` holds entry k of every lane), then scatter the lanes back. */
+#if defined(__AVX512F__)
+void DotNet35Random::seedBatch(DotNet35Random *out, const int *seeds, int count) {
+    constexpr int Lanes = 16;
+#if defined(DSPUGEN_RNG_STATS)
+    initCount += count - count % Lanes;
+#endif
+    const auto mbig = _mm512_set1_epi32(MBIG);
+    const auto zero = _mm512_setzero_si512();
+    int i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        __m512i arr[56];
+        auto num = _mm512_sub_epi32(_mm512_set1_epi32(MSEED),
+                                    _mm512_abs_epi32(_mm512_loadu_si512(seeds + i)));
+        arr[55] = num;
+        auto num2 = _mm512_set1_epi32(1);
+        for (int n = 1; n < 55; n++) {
+            int num3 = 21 * n % 55;
+            arr[num3] = num2;
+            auto t = _mm512_sub_epi32(num, num2);
+            num2 = _mm512_mask_add_epi32(t, _mm512_cmplt_epi32_mask(t, zero), t, mbig);
+            num = arr[num3];
+        }
+        for (int j = 1; j < 5; j++)
+            for (int k = 1; k < 56; k++) {
+                auto t = _mm512_sub_epi32(arr[k], arr[1 + (k + 30) % 55]);
+                arr[k] = _mm512_mask_add_epi32(t, _mm512_cmplt_epi32_mask(t, zero), t, mbig);
+            }
+        alignas(64) int lanes[56][Lanes];
+        for (int k = 1; k < 56; k++) _mm512_store_si512(lanes[k], arr[k]);
+        for (int l = 0; l < Lanes; l++) {
+            auto &r = out[i + l];
+            r.inext = 0;
+            r.inextp = 31;
+            r.seedArray[0] = 0;
+            for (int k = 1; k < 56; k++) r.seedArray[k] = lanes[k][l];
+        }
+    }
+    for (; i < count; i++) out[i] = DotNet35Random(seeds[i]);
+}
+#elif defined(__AVX2__)
+void DotNet35Random::seedBatch(DotNet35Random *out, const int *seeds, int count) {
+    constexpr int Lanes = 8;
+#if defined(DSPUGEN_RNG_STATS)
+    initCount += count - count % Lanes;
+#endif
+    const auto mbig = _mm256_set1_epi32(MBIG);
+    int i = 0;
+    for (; i + Lanes <= count; i += Lanes) {
+        __m256i arr[56];
+        auto num = _mm256_sub_epi32(_mm256_set1_epi32(MSEED),
+                                    _mm256_abs_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(seeds + i))));
+        arr[55] = num;
+        auto num2 = _mm256_set1_epi32(1);
+        for (int n = 1; n < 55; n++) {
+            int num3 = 21 * n % 55;
+            arr[num3] = num2;
+            auto t = _mm256_sub_epi32(num, num2);
+            num2 = _mm256_add_epi32(t, _mm256_and_si256(_mm256_srai_epi32(t, 31), mbig));
+            num = arr[num3];
+        }
+        for (int j = 1; j < 5; j++)
+            for (int k = 1; k < 56; k++) {
+                auto t = _mm256_sub_epi32(arr[k], arr[1 + (k + 30) % 55]);
+                arr[k] = _mm256_add_epi32(t, _mm256_and_si256(_mm256_srai_epi32(t, 31), mbig));
+            }
+        alignas(32) int lanes[56][Lanes];
+        for (int k = 1; k < 56; k++) _mm256_store_si256(reinterpret_cast<__m256i *>(lanes[k]), arr[k]);
+        for (int l = 0; l < Lanes; l++) {
+            auto &r = out[i + l];
+            r.inext = 0;
+            r.inextp = 31;
+            r.seedArray[0] = 0;
+            for (int k = 1; k < 56; k++) r.seedArray[k] = lanes[k][l];
+        }
+    }
+    for (; i < count; i++) out[i] = DotNet35Random(seeds[i]);
+}
+#else
+void DotNet35Random::seedBatch(DotNet35Random *out, const int *seeds, int count) {
+    for (int i = 0; i < count; i++) out[i] = DotNet35Random(seeds[i]);
+}
+#endif
+
 }
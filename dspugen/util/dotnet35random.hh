@@ -26,18 +26,47 @@ private:
     int inextp = 31;
     int seedArray[56] = {};
 
+    static constexpr double SampleScale = 4.6566128752457969E-10;
+
 private:
-    inline double sample() {
+    inline int rawSample() {
         if (++inext >= 56) inext = 1;
         if (++inextp >= 56) inextp = 1;
         int num = seedArray[inext] - seedArray[inextp];
         if (num < 0) num += MBIG;
         seedArray[inext] = num;
-        return static_cast<double>(num) * 4.6566128752457969E-10;
+        return num;
+    }
+
+    inline double sample() {
+        return static_cast<double>(rawSample()) * SampleScale;
+    }
+
+    /* Smallest raw sample `n` in [0, MBIG] for which `n * SampleScale` passes `test`.
+     * The scaled sample never decreases with `n`, so this is exact: starting from the
+     * quotient, it is only ever a step or two off */
+    template<typename Test>
+    static constexpr int rawCutoff(double threshold, Test test) {
+        if (!test(static_cast<double>(MBIG - 1) * SampleScale, threshold)) return MBIG;
+        if (test(0.0, threshold)) return 0;
+        auto raw = static_cast<int>(threshold / SampleScale);
+        while (raw > 0 && test(static_cast<double>(raw - 1) * SampleScale, threshold)) raw--;
+        while (!test(static_cast<double>(raw) * SampleScale, threshold)) raw++;
+        return raw;
     }
 
 public:
+#if defined(DSPUGEN_RNG_STATS)
+    /* generators seeded on this thread, by constructor or by seedBatch() */
+    static thread_local uint64_t initCount;
+#endif
+
+    DotNet35Random() = default;
     explicit DotNet35Random(int seed);
+
+    /* Seed `count` generators at once, 16/8 lanes per pass with AVX-512/AVX2,
+     * scalar otherwise. Result is bit-identical to `DotNet35Random(seeds[i])` */
+    static void seedBatch(DotNet35Random *out, const int *seeds, int count);
     inline int next() {
         return static_cast<int>(sample() * 2147483647.0);
     }
@@ -62,6 +91,23 @@ public:
     inline double nextDouble() {
         return sample();
     }
+
+    /* Draw of nextDouble() before scaling, in [0, int max). For draws only tested
+     * against a threshold: `nextDouble() >= t` is `nextRaw() >= rawAtLeast(t)` and
+     * `nextDouble() > t` is `nextRaw() >= rawAbove(t)`, `<` and `<=` being their
+     * negations, all with the same results. Keep constant cutoffs in constexpr
+     * variables so they fold at compile time */
+    inline int nextRaw() {
+        return rawSample();
+    }
+
+    static constexpr int rawAtLeast(double threshold) {
+        return rawCutoff(threshold, [](double value, double t) { return value >= t; });
+    }
+
+    static constexpr int rawAbove(double threshold) {
+        return rawCutoff(threshold, [](double value, double t) { return value > t; });
+    }
 };
 
 }
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <cstdint>
 
 namespace dspugen::util {
 
@@ -25,4 +26,16 @@ inline T lerp(T a, T b, T t) {
     return a + (b - a) * double(clamp01(t));
 }
 
+inline int bitCount(uint32_t v) {
+    v = v - ((v >> 1) & 0x55555555u);
+    v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+    return static_cast<int>((((v + (v >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+}
+
+/* Position of the `n`-th lowest set bit, `v` must have more than `n` set */
+inline int nthBitIndex(uint32_t v, int n) {
+    while (n-- > 0) v &= v - 1;
+    return bitCount((v & (0u - v)) - 1u);
+}
+
 }
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+#include "threadpool.hh"
+
+#include <algorithm>
+
+namespace dspugen::util {
+
+ThreadPool::ThreadPool(int threads) {
+    threads_.reserve(std::max(threads, 0));
+    for (int i = 0; i < threads; i++) {
+        threads_.emplace_back([this] { work(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock lock(mutex_);
+        quit_ = true;
+    }
+    wake_.notify_all();
+    for (auto &thread: threads_) thread.join();
+}
+
+void ThreadPool::run(int count, Func func, void *userdata) {
+    if (count <= 0) return;
+    if (threads_.empty() || count == 1) {
+        for (int i = 0; i < count; i++) func(i, userdata);
+        return;
+    }
+    {
+        std::unique_lock lock(mutex_);
+        func_ = func;
+        userdata_ = userdata;
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        pending_ = static_cast<int>(threads_.size());
+        generation_++;
+    }
+    wake_.notify_all();
+    drain(func, userdata, count);
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this] { return pending_ == 0; });
+}
+
+void ThreadPool::work() {
+    uint64_t seen = 0;
+    std::unique_lock lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this, seen] { return quit_ || generation_ != seen; });
+        if (quit_) return;
+        seen = generation_;
+        auto func = func_;
+        auto *userdata = userdata_;
+        auto count = count_;
+        lock.unlock();
+        drain(func, userdata, count);
+        lock.lock();
+        if (--pending_ == 0) done_.notify_one();
+    }
+}
+
+void ThreadPool::drain(Func func, void *userdata, int count) {
+    for (;;) {
+        auto index = next_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= count) return;
+        func(index, userdata);
+    }
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2024 Soar Qin<soarchin@gmail.com>
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dspugen::util {
+
+/* Small fixed set of worker threads splitting one job of indexed tasks, meant for
+ * short jobs where waking threads is all the overhead there is. The calling thread
+ * works on the job too, so a pool of `threads` workers runs `threads + 1` tasks at
+ * once. One job at a time, run() is not to be called from several threads */
+class ThreadPool final {
+public:
+    using Func = void (*)(int index, void *userdata);
+
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /* Threads working on a job, the caller included */
+    [[nodiscard]] inline int size() const { return static_cast<int>(threads_.size()) + 1; }
+
+    /* Calls `func(i, userdata)` for each `i` below `count`, in no given order,
+     * and returns once all calls did */
+    void run(int count, Func func, void *userdata);
+
+private:
+    void work();
+    void drain(Func func, void *userdata, int count);
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    Func func_ = nullptr;
+    void *userdata_ = nullptr;
+    int count_ = 0;
+    std::atomic<int> next_ {0};
+    /* Workers yet to finish the current job, each one takes part in every job */
+    int pending_ = 0;
+    uint64_t generation_ = 0;
+    bool quit_ = false;
+};
+
+}
@@ -12,40 +12,60 @@
 
 #include <fmt/ostream.h>
 #include <dlfcn.h>
+#include <algorithm>
 #include <vector>
 #include <filesystem>
 #include <iostream>
 
 struct FilterSet {
     SeedBeginFunc seedBegin;
+    SkeletonFilterFunc skeletonFilter;
     GalaxyFilterFunc galaxyFilter;
     StarFilterFunc starFilter;
     PlanetFilterFunc planetFilter;
+    StreamFilterFunc starStreamFilter;
+    StreamFilterFunc systemStreamFilter;
     SeedEndFunc seedEnd;
-    void *userp;
 };
 
 static std::vector<FilterSet> filters;
+/* What seedBegin() returned for the seed each thread works on, by filter */
+static thread_local std::vector<void*> userps;
 static std::vector<OutputFunc> outputFuncs;
 static std::vector<PoseFunc> poseFuncs;
 static std::vector<PluginUninitFunc> uninitFuncs;
+static bool allRequirementsKnown = true;
+static uint32_t requirementsMask = RequireNone;
+static bool allBirthOnly = true;
+static bool hasSkeletonFilter = false;
+static bool hasStarStreamFilter = false;
+static bool hasSystemStreamFilter = false;
+/* Seeds begin in runSkeletonFilters() when filters run before the galaxy is complete */
+static bool beginEarly = false;
 static bool hasStarFilter = false;
 static bool hasPlanetFilter = false;
 
 static void generateAllPlanets(const dspugen::Galaxy *galaxy) {
-    if (!galaxy->stars[0]->planets.empty()) return;
-    for (auto *star: galaxy->stars) {
-        star->createStarPlanets();
-    }
+    const_cast<dspugen::Galaxy*>(galaxy)->createAllPlanets();
+}
+
+static void generateStarPlanets(const dspugen::Star *star) {
+    star->galaxy->createPlanets(star->index);
 }
 
 static void generatePlanetGas(const dspugen::Planet *planet) {
     const_cast<dspugen::Planet*>(planet)->generateGas();
 }
 
+static const dspugen::GalaxyView *getGalaxyView(const dspugen::Galaxy *galaxy, bool withPlanets) {
+    return dspugen::GalaxyView::get(const_cast<dspugen::Galaxy*>(galaxy), withPlanets);
+}
+
 static PluginAPI api = {
     &generateAllPlanets,
     &generatePlanetGas,
+    &getGalaxyView,
+    &generateStarPlanets,
 };
 
 void loadFilters() {
@@ -73,17 +93,35 @@ void loadFilters() {
                 if (auto uninitfunc = reinterpret_cast<PluginUninitFunc>(dlsym(lib, "uninit"))) {
                     uninitFuncs.emplace_back(uninitfunc);
                 }
+                /* Pose filters never see a galaxy */
+                if (type == 0 || type == 1) {
+                    if (auto reqfunc = reinterpret_cast<PluginRequirementsFunc>(dlsym(lib, "requirements"))) {
+                        auto req = reqfunc();
+                        requirementsMask |= req & ~RequireBirthOnly;
+                        allBirthOnly = allBirthOnly && (req & RequireBirthOnly);
+                    } else {
+                        allRequirementsKnown = false;
+                    }
+                }
                 switch (type) {
                     case 0: {
                         FilterSet fs{
                             reinterpret_cast<SeedBeginFunc>(dlsym(lib, "seedBegin")),
+                            reinterpret_cast<SkeletonFilterFunc>(dlsym(lib, "skeletonFilter")),
                             reinterpret_cast<GalaxyFilterFunc>(dlsym(lib, "galaxyFilter")),
                             reinterpret_cast<StarFilterFunc>(dlsym(lib, "starFilter")),
                             reinterpret_cast<PlanetFilterFunc>(dlsym(lib, "planetFilter")),
+                            reinterpret_cast<StreamFilterFunc>(dlsym(lib, "starStreamFilter")),
+                            reinterpret_cast<StreamFilterFunc>(dlsym(lib, "systemStreamFilter")),
                             reinterpret_cast<SeedEndFunc>(dlsym(lib, "seedEnd"))
                         };
                         filters.emplace_back(fs);
-                        if (fs.galaxyFilter || fs.starFilter || fs.planetFilter || fs.seedEnd) {
+                        if (fs.skeletonFilter || fs.galaxyFilter || fs.starFilter || fs.planetFilter
+                            || fs.starStreamFilter || fs.systemStreamFilter || fs.seedEnd) {
+                            hasSkeletonFilter = hasSkeletonFilter || fs.skeletonFilter != nullptr;
+                            hasStarStreamFilter = hasStarStreamFilter || fs.starStreamFilter != nullptr;
+                            hasSystemStreamFilter = hasSystemStreamFilter || fs.systemStreamFilter != nullptr;
+                            beginEarly = hasSkeletonFilter || hasStarStreamFilter || hasSystemStreamFilter;
                             hasStarFilter = hasStarFilter || fs.starFilter != nullptr;
                             hasPlanetFilter = hasStarFilter || fs.planetFilter != nullptr;
                             if (pname) {
@@ -125,10 +163,75 @@ void loadFilters() {
     }
 }
 
+bool pluginRequirements(uint32_t &mask) {
+    if (!allRequirementsKnown) return false;
+    mask = requirementsMask | (allBirthOnly ? RequireBirthOnly : RequireNone);
+    return true;
+}
+
+/* Also true with only stream filters loaded, runSkeletonFilters() begins the seeds for them */
+bool hasSkeletonFilters() {
+    return beginEarly;
+}
+
+static void beginSeed(int seed) {
+    userps.resize(filters.size());
+    for (size_t i = 0; i < filters.size(); i++) {
+        userps[i] = filters[i].seedBegin ? filters[i].seedBegin(seed) : nullptr;
+    }
+}
+
+/* Runs before any star is generated. Seeds begin here when skeleton or stream
+ * filters are loaded, so runFilters() keeps the userp returned by seedBegin() */
+bool runSkeletonFilters(const dspugen::GalaxySkeleton &skeleton) {
+    beginSeed(skeleton.seed);
+    for (size_t i = 0; i < filters.size(); i++) {
+        const auto &fs = filters[i];
+        if (fs.skeletonFilter && !fs.skeletonFilter(&skeleton, userps[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Filters keeping per seed state from seedBegin() */
+bool hasSeedStates() {
+    return std::any_of(filters.begin(), filters.end(), [](const FilterSet &fs) { return fs.seedBegin != nullptr; });
+}
+
+bool hasStarStreamFilters() {
+    return hasStarStreamFilter;
+}
+
+bool hasSystemStreamFilters() {
+    return hasSystemStreamFilter;
+}
+
+bool runStarStreamFilters(const dspugen::Star &star) {
+    for (size_t i = 0; i < filters.size(); i++) {
+        const auto &fs = filters[i];
+        if (fs.starStreamFilter && !fs.starStreamFilter(&star, userps[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool runSystemStreamFilters(const dspugen::Star &star) {
+    for (size_t i = 0; i < filters.size(); i++) {
+        const auto &fs = filters[i];
+        if (fs.systemStreamFilter && !fs.systemStreamFilter(&star, userps[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool runFilters(const dspugen::Galaxy *galaxy) {
-    for (auto &fs: filters) {
-        fs.userp = fs.seedBegin ? fs.seedBegin(galaxy->seed) : nullptr;
-        if (fs.galaxyFilter && !fs.galaxyFilter(galaxy, fs.userp)) {
+    if (!beginEarly) beginSeed(galaxy->seed);
+    for (size_t i = 0; i < filters.size(); i++) {
+        const auto &fs = filters[i];
+        if (fs.galaxyFilter && !fs.galaxyFilter(galaxy, userps[i])) {
             return false;
         }
     }
@@ -136,17 +239,19 @@ bool runFilters(const dspugen::Galaxy *galaxy) {
         bool pass = true;
         for (auto &s: galaxy->stars) {
             pass = true;
-            for (const auto &fs: filters) {
-                if(fs.starFilter && !fs.starFilter(s, fs.userp)) {
+            for (size_t i = 0; i < filters.size(); i++) {
+                const auto &fs = filters[i];
+                if(fs.starFilter && !fs.starFilter(s, userps[i])) {
                     pass = false;
                     break;
                 }
             }
             if (!pass) { continue; }
             pass = false;
-            for (const auto &p: s->planets) {
-                for (const auto &fs: filters) {
-                    if (!fs.planetFilter || fs.planetFilter(p, fs.userp)) {
+            for (const auto &p: s->planets()) {
+                for (size_t i = 0; i < filters.size(); i++) {
+                    const auto &fs = filters[i];
+                    if (!fs.planetFilter || fs.planetFilter(p, userps[i])) {
                         pass = true;
                     }
                 }
@@ -159,8 +264,9 @@ bool runFilters(const dspugen::Galaxy *galaxy) {
     } else if (hasStarFilter) {
         bool pass = true;
         for (auto &s: galaxy->stars) {
-            for (const auto &fs: filters) {
-                if(fs.starFilter && !fs.starFilter(s, fs.userp)) {
+            for (size_t i = 0; i < filters.size(); i++) {
+                const auto &fs = filters[i];
+                if(fs.starFilter && !fs.starFilter(s, userps[i])) {
                     pass = false;
                     break;
                 }
@@ -171,8 +277,9 @@ bool runFilters(const dspugen::Galaxy *galaxy) {
         }
         if (!pass) { return false; }
     }
-    for (const auto &fs: filters) {
-        if (fs.seedEnd && !fs.seedEnd(fs.userp)) {
+    for (size_t i = 0; i < filters.size(); i++) {
+        const auto &fs = filters[i];
+        if (fs.seedEnd && !fs.seedEnd(userps[i])) {
             return false;
         }
     }
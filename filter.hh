@@ -9,8 +9,17 @@
 #pragma once
 
 #include "dspugen/galaxy.hh"
+#include "dspugen/galaxyview.hh"
 
 extern void loadFilters();
+extern bool pluginRequirements(uint32_t &mask);
+extern bool hasSkeletonFilters();
+extern bool hasSeedStates();
+extern bool runSkeletonFilters(const dspugen::GalaxySkeleton&);
+extern bool hasStarStreamFilters();
+extern bool hasSystemStreamFilters();
+extern bool runStarStreamFilters(const dspugen::Star&);
+extern bool runSystemStreamFilters(const dspugen::Star&);
 extern bool runFilters(const dspugen::Galaxy*);
 extern bool runPoseFilters(int, int, const std::vector<dspugen::VectorLF3>&);
 extern bool runOutput(const dspugen::Galaxy*);
@@ -22,18 +31,46 @@ extern void unloadFilters();
 #define FILTERAPI
 #endif
 
+/* What a plugin reads, returned by its optional `requirements()` export.
+ * When every loaded plugin tells, the engine generates only what is asked for */
+enum PluginRequirement : uint32_t {
+    RequireNone = 0,
+    RequireNames = 1u << 0,
+    RequirePositions = 1u << 1,
+    /* All planets built before the filters run, plugins calling GenerateStarPlanets()
+     * or GenerateAllPlanets() themselves can leave this out */
+    RequirePlanets = 1u << 2,
+    RequireVeins = 1u << 3,
+    /* Gas filled as planets are built, plugins calling GeneratePlanetGas() can leave this
+     * out, but gas speeds scale with the star distance so they need positions then */
+    RequireGas = 1u << 4,
+    /* Only the birth star is looked at, applies only if all plugins set it */
+    RequireBirthOnly = 1u << 5,
+};
+
 struct PluginAPI {
     void (*GenerateAllPlanets)(const dspugen::Galaxy *galaxy);
     void (*GeneratePlanetGas)(const dspugen::Planet *planet);
+    /* Arrays of all star (and planet if `withPlanets`) fields for vectorized scans */
+    const dspugen::GalaxyView *(*GetGalaxyView)(const dspugen::Galaxy *galaxy, bool withPlanets);
+    /* Planets of `star` and of the stars before it, the rest of the galaxy is left alone */
+    void (*GenerateStarPlanets)(const dspugen::Star *star);
 };
 
 using PluginInitFunc = const char*(FILTERAPI*)(PluginAPI*, int*);
 using PluginInit2Func = const char*(FILTERAPI*)(PluginAPI*, int*, bool);
 using PluginUninitFunc = void(FILTERAPI*)();
+using PluginRequirementsFunc = uint32_t(FILTERAPI*)();
 using SeedBeginFunc = void*(FILTERAPI*)(int);
+using SkeletonFilterFunc = bool(FILTERAPI*)(const dspugen::GalaxySkeleton*, void*);
 using GalaxyFilterFunc = bool(FILTERAPI*)(const dspugen::Galaxy*, void*);
 using StarFilterFunc = bool(FILTERAPI*)(const dspugen::Star*, void*);
 using PlanetFilterFunc = bool(FILTERAPI*)(const dspugen::Planet*, void*);
+/* `starStreamFilter` and `systemStreamFilter` run while the galaxy is generated, on each
+ * star once built and once its planets are built (planets get generated for them).
+ * Returning false drops the galaxy right away. Only stars up to the one passed exist
+ * then, so GenerateAllPlanets() and GetGalaxyView() must not be called from them */
+using StreamFilterFunc = bool(FILTERAPI*)(const dspugen::Star*, void*);
 using SeedEndFunc = bool(FILTERAPI*)(void*);
 
 using OutputFunc = void(FILTERAPI*)(const dspugen::Galaxy*);
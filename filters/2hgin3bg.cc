@@ -15,6 +15,15 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI*, int *type) {
     return "2 Blue Giants with high luminosity in 3 Blue Giant Seeds";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequireNone;
+}
+
+/* Both blue giants must be giants, so seeds laid out with fewer are dropped early */
+__declspec(dllexport) bool FILTERAPI skeletonFilter(const dspugen::GalaxySkeleton *skeleton, void*) {
+    return skeleton->giantCount >= 2;
+}
+
 __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
     int cnt2 = 0;
     for (const auto *star: g->stars) {
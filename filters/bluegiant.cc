@@ -10,20 +10,36 @@
 
 extern "C" {
 
-__declspec(dllexport) const char *FILTERAPI init(PluginAPI*, int *type) {
+static PluginAPI *theAPI = nullptr;
+
+__declspec(dllexport) const char *FILTERAPI init(PluginAPI *api, int *type) {
+    theAPI = api;
     *type = 0;
     return "2 Blue Giants with high luminosity";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequireNone;
+}
+
+/* Both blue giants must be giants, so seeds laid out with fewer are dropped early */
+__declspec(dllexport) bool FILTERAPI skeletonFilter(const dspugen::GalaxySkeleton *skeleton, void*) {
+    return skeleton->giantCount >= 2;
+}
+
 __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
+    constexpr auto giant = static_cast<int8_t>(dspugen::EStarType::GiantStar);
+    constexpr auto o = static_cast<int8_t>(dspugen::ESpectrType::O);
+    const auto *view = theAPI->GetGalaxyView(g, false);
+    const auto *type = view->type;
+    const auto *spectr = view->spectr;
+    const auto *luminosity = view->luminosity;
+    /* Branch-free over the padded lanes so the compiler can vectorize it */
     int cnt = 0, cnt2 = 0;
-    for (const auto *star: g->stars) {
-        if (star->type == dspugen::EStarType::GiantStar && star->spectr == dspugen::ESpectrType::O) {
-            ++cnt;
-            if (star->luminosity >= /*19.832529646959319302266016012115f*/ 18.092348467648446913917646190829f /*16.064927362833999424416458640845f*/) {
-                ++cnt2;
-            }
-        }
+    for (int i = 0; i < view->starStride; i++) {
+        int match = (type[i] == giant) & (spectr[i] == o);
+        cnt += match;
+        cnt2 += match & (luminosity[i] >= /*19.832529646959319302266016012115f*/ 18.092348467648446913917646190829f /*16.064927362833999424416458640845f*/);
     }
     if (cnt == 2 && cnt2 == 2) {
         fprintf(stdout, "%d,%d\n", g->seed, g->starCount);
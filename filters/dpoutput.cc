@@ -26,6 +26,10 @@ __declspec(dllexport) const char *FILTERAPI init2(PluginAPI *api, int *type, boo
     return "DSP-Power Related Output";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequirePositions | RequireVeins;
+}
+
 __declspec(dllexport) void FILTERAPI uninit() {
     starOut.close();
 }
@@ -77,11 +81,11 @@ __declspec(dllexport) void FILTERAPI output(const dspugen::Galaxy *galaxy) {
     int hgCnt = 0;
     if (!planets) theAPI->GenerateAllPlanets(galaxy);
     for (auto *star: galaxy->stars) {
-        for (const auto *planet: star->planets) {
+        for (const auto *planet: star->planets()) {
             steeps += planet->veinSpot[7];
         }
         if (star->index == 0) {
-            for (const auto *planet: star->planets) {
+            for (const auto *planet: star->planets()) {
                 switch (planet->theme) {
                     case 2:
                     case 3:
@@ -107,7 +111,7 @@ __declspec(dllexport) void FILTERAPI output(const dspugen::Galaxy *galaxy) {
                 case dspugen::EStarType::GiantStar:
                     if (star->spectr == dspugen::ESpectrType::O) {
                         int cnt = 0;
-                        for (auto *planet: star->planets) {
+                        for (auto *planet: star->planets()) {
                             switch (planet->theme) {
                                 case 2:
                                 case 3:
@@ -116,11 +120,11 @@ __declspec(dllexport) void FILTERAPI output(const dspugen::Galaxy *galaxy) {
                                     break;
                                 case 21: {
                                     theAPI->GeneratePlanetGas(planet);
-                                    auto &gasItems = planet->gasItems;
+                                    auto &gasItems = planet->gasItems();
                                     size_t sz = gasItems.size();
                                     for (size_t i = 0; i < sz; i++) {
                                         /* Gas Giant with Deuterium(1121) >= 0.15 (0.1875x0.8 under 0.1x resource) */
-                                        if (gasItems[i] == 1121 && planet->gasSpeeds[i] >= 0.1875f) {
+                                        if (gasItems[i] == 1121 && planet->gasSpeeds()[i] >= 0.1875f) {
                                             hgId[hgCnt++] = planet->id;
                                         }
                                     }
@@ -145,20 +149,20 @@ __declspec(dllexport) void FILTERAPI output(const dspugen::Galaxy *galaxy) {
                         oCount++;
                     }
                     if (star->luminosity >= 4.99263753f) {
-                        auto *planet = star->planets[0];
+                        auto *planet = star->planets()[0];
                         auto dysonRad = std::round(star->dysonRadius * 40000.0 / 100.0) * 100.0;
                         if (isThemeFullPower(planet->theme, planet->orbitRadius * 40000.0, dysonRad)) {
                             lumId[lumCnt++] = planet->id;
                         }
                         /* Luminosity >= 2.04f, can have 2 full planet photon receivers */
                         if (star->luminosity >= 8.675074184f) {
-                            planet = star->planets[1];
+                            planet = star->planets()[1];
                             if (isThemeFullPower(planet->theme, planet->orbitRadius * 40000.0, dysonRad)) {
                                 lumId[lumCnt++] = planet->id;
                             }
                         }
                     }
-                    for (const auto *planet: star->planets) {
+                    for (const auto *planet: star->planets()) {
                         switch (planet->theme) {
                             case 16:
                                 waterCount++;
@@ -168,11 +172,11 @@ __declspec(dllexport) void FILTERAPI output(const dspugen::Galaxy *galaxy) {
                                 break;
                             case 21: {
                                 theAPI->GeneratePlanetGas(planet);
-                                auto &gasItems = planet->gasItems;
+                                auto &gasItems = planet->gasItems();
                                 size_t sz = gasItems.size();
                                 for (size_t i = 0; i < sz; i++) {
                                     /* Gas Giant with Deuterium(1121) >= 0.15 (0.1875x0.8 under 0.1x resource) */
-                                    if (gasItems[i] == 1121 && planet->gasSpeeds[i] >= 0.1875f) {
+                                    if (gasItems[i] == 1121 && planet->gasSpeeds()[i] >= 0.1875f) {
                                         hgId[hgCnt++] = planet->id;
                                     }
                                 }
@@ -185,7 +189,7 @@ __declspec(dllexport) void FILTERAPI output(const dspugen::Galaxy *galaxy) {
                     break;
                 case dspugen::EStarType::BlackHole:
                 case dspugen::EStarType::NeutronStar:
-                    for (const auto *planet: star->planets) {
+                    for (const auto *planet: star->planets()) {
                         magnetCount += planet->veinSpot[14];
                     }
                     break;
@@ -10,16 +10,24 @@
 
 extern "C" {
 
+static PluginAPI *theAPI = nullptr;
+
 __declspec(dllexport) const char *FILTERAPI init(PluginAPI *api, int *type) {
+    theAPI = api;
     *type = 0;
     return "Has Fire-Ice on any planet in birth star, with at least 2 O-star luminosity >= 2.4 and at least one with tidy-locked planet(s)";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequireVeins | RequireBirthOnly;
+}
+
 __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
     const auto *star = g->starById(g->birthStarId);
     if (!star) { return false; }
+    theAPI->GenerateStarPlanets(star);
     bool foundFI = false, foundGas = false;
-    for (const auto *p: star->planets) {
+    for (const auto *p: star->planets()) {
         if (p->orbitAround > 0 && p->theme == 7 && p->veinSpot[8] > 3) {
             foundFI = true;
             if (foundGas) { return true; }
@@ -25,6 +25,10 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *, int *type) {
     return "For Fun Seeds";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequireBirthOnly;
+}
+
 __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
     const auto *star = g->stars[0];
     {
@@ -21,6 +21,10 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *api, int *type) {
     return "Highest Gas Giant in Birth Star";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequireBirthOnly;
+}
+
 __declspec(dllexport) void FILTERAPI uninit() {
     fmt::println("Highest Gas Giant in Birth Star: {}({}), {}({}), {}({}), {}({})",
                highestId[0], highestValue[0], highestId[1], highestValue[1],
@@ -31,30 +35,31 @@ __declspec(dllexport) void FILTERAPI uninit() {
 __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
     const auto *star = g->stars[0];
     if (!star) { return false; }
-    for (const auto *p: star->planets) {
+    pluginAPI->GenerateStarPlanets(star);
+    for (const auto *p: star->planets()) {
         switch (p->theme) {
             case 2:
             case 3:
             case 21:
                 pluginAPI->GeneratePlanetGas(p);
-                if (p->gasSpeeds[0] > highestValue[0]) {
-                    highestValue[0] = p->gasSpeeds[0];
+                if (p->gasSpeeds()[0] > highestValue[0]) {
+                    highestValue[0] = p->gasSpeeds()[0];
                     highestId[0] = g->seed;
                 }
-                if (p->gasSpeeds[1] > highestValue[1]) {
-                    highestValue[1] = p->gasSpeeds[1];
+                if (p->gasSpeeds()[1] > highestValue[1]) {
+                    highestValue[1] = p->gasSpeeds()[1];
                     highestId[1] = g->seed;
                 }
                 break;
             case 4:
             case 5:
                 pluginAPI->GeneratePlanetGas(p);
-                if (p->gasSpeeds[0] > highestValue[2]) {
-                    highestValue[2] = p->gasSpeeds[0];
+                if (p->gasSpeeds()[0] > highestValue[2]) {
+                    highestValue[2] = p->gasSpeeds()[0];
                     highestId[2] = g->seed;
                 }
-                if (p->gasSpeeds[1] > highestValue[3]) {
-                    highestValue[3] = p->gasSpeeds[1];
+                if (p->gasSpeeds()[1] > highestValue[3]) {
+                    highestValue[3] = p->gasSpeeds()[1];
                     highestId[3] = g->seed;
                 }
                 break;
@@ -51,6 +51,10 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *api, int *type) {
     return "Min/Max count of each theme";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequirePositions | RequirePlanets;
+}
+
 __declspec(dllexport) void FILTERAPI uninit() {
     for (int i = 0; i < 22; i++) {
         std::string maxIds;
@@ -82,7 +86,7 @@ __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
     float total[2] = {0.f, 0.f};
     int count[22] = {0};
     for (auto *star: g->stars) {
-        for (const auto *p: star->planets) {
+        for (const auto *p: star->planets()) {
             int index = themeIdMap[p->theme];
             if (index < 0) {
                 continue;
@@ -93,14 +97,14 @@ __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
                 case 3:
                 case 21:
                     pluginAPI->GeneratePlanetGas(p);
-                    total[0] += p->gasSpeeds[0];
-                    total[1] += p->gasSpeeds[1];
-                    if (p->gasSpeeds[0] > highestValue[0]) {
-                        highestValue[0] = p->gasSpeeds[0];
+                    total[0] += p->gasSpeeds()[0];
+                    total[1] += p->gasSpeeds()[1];
+                    if (p->gasSpeeds()[0] > highestValue[0]) {
+                        highestValue[0] = p->gasSpeeds()[0];
                         highestId[0] = g->seed;
                     }
-                    if (p->gasSpeeds[1] > highestValue[1]) {
-                        highestValue[1] = p->gasSpeeds[1];
+                    if (p->gasSpeeds()[1] > highestValue[1]) {
+                        highestValue[1] = p->gasSpeeds()[1];
                         highestId[1] = g->seed;
                     }
                     break;
@@ -22,6 +22,10 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *, int *type) {
     return "Max B Seeds";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequireNone;
+}
+
 __declspec(dllexport) void FILTERAPI uninit() {
     fmt::println("Max B Count: {}", bMaxCount);
     for (auto seed: bSeeds) {
@@ -74,6 +74,10 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *, int *type) {
     return "For Fun 6";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequirePositions;
+}
+
 __declspec(dllexport) void FILTERAPI uninit() {
     fmt::print("B Min Lum: ");
     for (auto seed: bMinSeeds) {
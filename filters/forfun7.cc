@@ -21,6 +21,10 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *, int *type) {
     return "For Fun 7";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequirePlanets;
+}
+
 __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
     int bgCnt = 0;
     float lum[3] = {0.f, 0.f, 0.f};
@@ -29,7 +33,7 @@ __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
             case dspugen::EStarType::GiantStar:
                 if (s->spectr == dspugen::ESpectrType::O) {
                     int pCnt = 0;
-                    for (auto *p: s->planets) {
+                    for (auto *p: s->planets()) {
                         switch (p->theme) {
                             case 2:
                             case 3:
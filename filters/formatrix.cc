@@ -32,6 +32,10 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *api, int *type) {
     return "Filter for Manufacturing Universe Matrices";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequireNames | RequirePositions | RequireVeins;
+}
+
 __declspec(dllexport) void FILTERAPI uninit() {
     ofs->close();
     delete ofs;
@@ -130,15 +134,15 @@ __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
             case dspugen::EStarType::MainSeqStar:
                 /* Luminosity >= 1.7f, can have al least 1 full planet photon receivers */
                 if (star->luminosity >= 4.99263753f) {
-                    auto *planet = star->planets[0];
+                    auto *planet = star->planets()[0];
                     auto dysonRad = std::round(star->dysonRadius * 80000.0 / 100.0) * 100.0;
-                    auto rad = (planet->orbitAroundPlanet ? planet->orbitAroundPlanet->orbitRadius : planet->orbitRadius) * 40000.0;
+                    auto rad = (planet->orbitAroundPlanet() ? planet->orbitAroundPlanet()->orbitRadius : planet->orbitRadius) * 40000.0;
                     if (isThemeFullPower(planet->theme, rad, dysonRad)) {
                         lumId[lumCnt++] = planet->id;
                     }
                     /* Luminosity >= 2.04f, can have 2 full planet photon receivers */
                     if (star->luminosity >= 8.675074184f) {
-                        planet = star->planets[1];
+                        planet = star->planets()[1];
                         if (isThemeFullPower(planet->theme, rad, dysonRad)) {
                             lumId[lumCnt++] = planet->id;
                         }
@@ -147,7 +151,7 @@ __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
                 break;
             case dspugen::EStarType::BlackHole:
             case dspugen::EStarType::NeutronStar: {
-                auto *planet = star->planets[0];
+                auto *planet = star->planets()[0];
                 umCount += planet->veinSpot[14];
                 break;
             }
@@ -159,7 +163,7 @@ __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
         switch (star->type) {
             case dspugen::EStarType::MainSeqStar:
             case dspugen::EStarType::GiantStar:
-                for (const auto *planet: star->planets) {
+                for (const auto *planet: star->planets()) {
                     switch (planet->theme) {
                         case 16:
                             water++;
@@ -169,11 +173,11 @@ __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
                             break;
                         case 21: {
                             theAPI->GeneratePlanetGas(planet);
-                            auto &gasItems = planet->gasItems;
+                            auto &gasItems = planet->gasItems();
                             size_t sz = gasItems.size();
                             for (size_t i = 0; i < sz; i++) {
                                 /* Gas Giant with Deuterium(1121) >= 0.15 (0.1875x0.8 under 0.1x resource) */
-                                if (gasItems[i] == 1121 && planet->gasSpeeds[i] >= 0.1875f) {
+                                if (gasItems[i] == 1121 && planet->gasSpeeds()[i] >= 0.1875f) {
                                     hgId[highHydrogen++] = planet->id;
                                 }
                             }
@@ -196,7 +200,7 @@ __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
         if (dist > maxDist) {
             maxDist = dist;
         }
-        for (const auto *planet: star->planets) {
+        for (const auto *planet: star->planets()) {
             steeps += planet->veinSpot[7];
         }
     }
@@ -208,8 +212,8 @@ __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
             return;
         }
         countedStars.insert(star->id);
-        cnt[0] += static_cast<int>(star->planets.size());
-        for (const auto *planet: star->planets) {
+        cnt[0] += static_cast<int>(star->planets().size());
+        for (const auto *planet: star->planets()) {
             if (lumSet.find(planet->id) != lumSet.end()) {
                 continue;
             }
@@ -278,7 +282,7 @@ __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
             allLumPlanets += '|';
         }
         auto *star = g->starById(lumId[i] / 100);
-        allLumPlanets += star->name;
+        allLumPlanets += star->name();
         allLumPlanets += ' ';
         allLumPlanets += id2roman(lumId[i] % 100);
     }
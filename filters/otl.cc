@@ -15,11 +15,15 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *api, int *type) {
     return "O Star With Tidal-Locked Planets";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequirePlanets;
+}
+
 __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
     int cnt = 0;
     for (const auto *star: g->stars) {
         if (star->spectr != dspugen::ESpectrType::O) { continue; }
-        for (auto *planet: star->planets) {
+        for (auto *planet: star->planets()) {
             if (planet->singularity & dspugen::EPlanetSingularity::TidalLocked) {
                 if (++cnt > 0) {
                     return true;
@@ -25,6 +25,10 @@ __declspec(dllexport) const char *FILTERAPI init2(PluginAPI *api, int *type, boo
     return "Planet output";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequireNames | RequireVeins;
+}
+
 __declspec(dllexport) void FILTERAPI uninit() {
     planetOut.close();
 }
@@ -73,12 +77,12 @@ static inline std::string id2roman(int id) {
 __declspec(dllexport) void FILTERAPI output(const dspugen::Galaxy *galaxy) {
     theAPI->GenerateAllPlanets(galaxy);
     for (auto *star: galaxy->stars) {
-        for (const auto *planet: star->planets) {
+        for (const auto *planet: star->planets()) {
             fmt::print(planetOut, "{},{},{},{},{},{},{},{},{},{},{},{}\n",
                galaxy->seed,
                galaxy->starCount,
                planet->id,
-               star->name + ' ' + id2roman(planet->id % 100),
+               std::string(star->name()) + ' ' + id2roman(planet->id % 100),
                planet->theme,
                planet->orbitRadius,
                planet->orbitAround,
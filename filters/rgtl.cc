@@ -15,12 +15,16 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *api, int *type) {
     return "Red Giant With Volcano/Water and 2 Tidal-Locked Planets";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequirePlanets;
+}
+
 __declspec(dllexport) bool FILTERAPI starFilter(const dspugen::Star *star) {
     if (star->type == dspugen::EStarType::GiantStar && star->spectr <= dspugen::ESpectrType::K) {
         int cnt = 0;
         bool foundV = false;
         bool foundW = false;
-        for (auto *planet: star->planets) {
+        for (auto *planet: star->planets()) {
             if (planet->singularity & dspugen::EPlanetSingularity::TidalLocked) {
                 ++cnt;
             }
@@ -24,6 +24,10 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *api, int *type) {
     return "Star output";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequireNames;
+}
+
 __declspec(dllexport) void FILTERAPI uninit() {
     starOut.close();
 }
@@ -111,7 +115,7 @@ __declspec(dllexport) void FILTERAPI output(const dspugen::Galaxy *galaxy) {
                    galaxy->seed,
                    galaxy->starCount,
                    star->id,
-                   star->name,
+                   star->name(),
                    std::pow(star->luminosity, 0.33000001311302185f),
                    SpectrToString(star->type, star->spectr)
         );
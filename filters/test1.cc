@@ -33,6 +33,10 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *api, int *type) {
     return "Filter for planets that full coated by Dyson Sphere";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequireNone;
+}
+
 __declspec(dllexport) void FILTERAPI uninit() {
     static const char *name[] = {
         "M", "K", "G", "F", "A", "B", "O", "Red Giant", "Yellow Giant", "White Giant", "Blue Giant", "White Dwarf", "Black Hole", "Neutron Star"
@@ -74,21 +78,21 @@ static inline int calcIndex(const dspugen::Star *star) {
 
 static inline void calcData(const dspugen::Star *star) {
     auto dysonRad = std::round(float(star->dysonRadius * 40000.0) * 2.0f / 100.0f) * 100.0f;
-    auto *firstPlanet = star->planets[0];
+    auto *firstPlanet = star->planets()[0];
     auto firstRad = float(double(firstPlanet->orbitRadius) * 40000.0);
     auto &d = data[calcIndex(star)];
     if (dysonRad - firstRad >= 2199.95f) {
         d.planet1CoatedCount++;
-        if (star->planets.size() > 1 && dysonRad > float(double(star->planets[1]->orbitRadius) * 40000.0)) {
+        if (star->planets().size() > 1 && dysonRad > float(double(star->planets()[1]->orbitRadius) * 40000.0)) {
             d.planet2CoatedCount++;
             fmt::print("Seed: {}, Star: {}\n", star->galaxy->seed, star->id);
         }
     }
-    if (firstPlanet->orbitIndex == 1) {
+    if (firstPlanet->orbitIndex() == 1) {
         d.orbit1PlanetCount++;
     }
     d.starCount++;
-    d.totalCount += int64_t(star->planets.size());
+    d.totalCount += int64_t(star->planets().size());
 }
 
 __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
@@ -19,6 +19,10 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *, int *type) {
     return "Check special seeds";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequireNone;
+}
+
 __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
     int count[3] = {};
     for (const auto *s: g->stars) {
@@ -21,13 +21,17 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *api, int *type) {
     return "Check special seeds";
 }
 
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequirePositions | RequirePlanets | RequireVeins;
+}
+
 __declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
     int count = {};
     double dist[2];
     for (int i = 62; i < 64; i++) {
         auto *star = g->stars[i];
         dist[i - 62] = star->position.magnitude();
-        for (auto &p: star->planets) {
+        for (auto &p: star->planets()) {
             count += p->veinSpot[14];
         }
     }
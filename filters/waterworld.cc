@@ -15,34 +15,54 @@ __declspec(dllexport) const char *FILTERAPI init(PluginAPI *api, int *type) {
     return "Water world";
 }
 
-__declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g) {
-    int cnt = 0, cnt2 = 0, cnt3 = 0;
-    for (const auto *star: g->stars) {
-        switch (star->type) {
-        case dspugen::EStarType::BlackHole:
-        case dspugen::EStarType::NeutronStar:
-            for (auto *planet: star->planets) {
-                cnt3 += planet->veinSpot[14];
-            }
-            break;
-        default:
-            for (auto *planet: star->planets) {
-                switch (planet->theme) {
-                case 16:
-                    ++cnt;
-                    break;
-                case 23:
-                    ++cnt2;
-                    break;
-                default:
-                    break;
-                }
+__declspec(dllexport) uint32_t FILTERAPI requirements() {
+    return RequirePlanets | RequireVeins;
+}
+
+struct Counts {
+    int cnt, cnt2, cnt3;
+};
+
+static thread_local Counts counts;
+
+__declspec(dllexport) void *FILTERAPI seedBegin(int) {
+    counts = {};
+    return &counts;
+}
+
+__declspec(dllexport) bool FILTERAPI systemStreamFilter(const dspugen::Star *star, void *userp) {
+    auto &c = *static_cast<Counts*>(userp);
+    switch (star->type) {
+    case dspugen::EStarType::BlackHole:
+    case dspugen::EStarType::NeutronStar:
+        /* Only neutron stars and black holes follow, no more water worlds can come */
+        if (c.cnt <= 5 || c.cnt2 <= 9) { return false; }
+        for (auto *planet: star->planets()) {
+            c.cnt3 += planet->veinSpot[14];
+        }
+        break;
+    default:
+        for (auto *planet: star->planets()) {
+            switch (planet->theme) {
+            case 16:
+                ++c.cnt;
+                break;
+            case 23:
+                ++c.cnt2;
+                break;
+            default:
+                break;
             }
-            break;
         }
+        break;
     }
-    if (cnt > 5 && cnt2 > 9 && cnt3 > 19) {
-        fprintf(stdout, "%d: %d %d %d\n", g->seed, cnt, cnt2, cnt3);
+    return true;
+}
+
+__declspec(dllexport) bool FILTERAPI galaxyFilter(const dspugen::Galaxy *g, void *userp) {
+    const auto &c = *static_cast<const Counts*>(userp);
+    if (c.cnt > 5 && c.cnt2 > 9 && c.cnt3 > 19) {
+        fprintf(stdout, "%d: %d %d %d\n", g->seed, c.cnt, c.cnt2, c.cnt3);
         return true;
     }
     return false;
@@ -1,12 +1,22 @@
 #include "galaxy.hh"
+#include "gencontext.hh"
 #include "protoset.hh"
 #include "filter.hh"
 #include "settings.hh"
+#if defined(DSPUGEN_RNG_STATS)
+#include "util/dotnet35random.hh"
+#endif
+#if defined(DSPUGEN_ALLOC_CHECK)
+#include "util/alloccount.hh"
+#include <cstdlib>
+#include <new>
+#endif
 
 #include <fmt/ostream.h>
 #include <fmt/format.h>
 #include <getopt.h>
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <mutex>
 #include <thread>
@@ -15,15 +25,66 @@
 #include <map>
 
 static std::mutex mutex1, mutex2;
-static std::map<int, std::vector<std::pair<int, int>>> seedsToCheckMap;
+/* Seed ranges by star count range, which only spans several counts with -s */
+static std::map<std::pair<int, int>, std::vector<std::pair<int, int>>> seedsToCheckMap;
 static std::vector<std::pair<int, int>> *seedsToCheck = nullptr;
 static size_t currIndex = 0, totalSize = 0;
-static int current = -1, currMax = -1, starCount = 64;
+static int current = -1, currMax = -1, starCount = 64, sweepMaxStars = 64;
+static dspugen::GalaxyCreateFunc createGalaxy = nullptr;
+/* Set for star count ranges, each seed is then generated once for all counts */
+static dspugen::GalaxySweepFunc sweepGalaxies = nullptr;
+/* Set when seeds are generated `batchSize` at a time, one stage over all of them after another */
+static dspugen::GalaxyBatchFunc batchGalaxies = nullptr;
+static int batchSize = 64;
 
 static bool poseOnly = false;
+static bool sweep = false;
 static std::ofstream *outputStream;
 static int found = 0;
 static std::chrono::time_point<std::chrono::steady_clock> *startTime;
+#if defined(DSPUGEN_RNG_STATS)
+static std::atomic<uint64_t> rngInitTotal = 0, galaxyTotal = 0;
+#endif
+#if defined(DSPUGEN_ALLOC_CHECK)
+static std::atomic<bool> allocCheckFailed = false;
+
+void *operator new(std::size_t size) {
+    ++dspugen::util::heapAllocCount;
+    if (auto *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+/* Once a thread has run DSPUGEN_ALLOC_CHECK seeds its buffers are warmed up,
+ * generating and filtering a galaxy must not allocate anymore. `processed` is
+ * the count before the galaxies checked, so a first batch is never checked */
+static void checkAllocs(int seed, uint64_t processed, uint64_t allocCount) {
+    auto count = dspugen::util::heapAllocCount - allocCount;
+    if (processed < DSPUGEN_ALLOC_CHECK || count == 0) return;
+    if (!allocCheckFailed.exchange(true)) {
+        fmt::print(std::cerr, "Heap allocated {} times while processing seed {},{}\n", count, seed, starCount);
+    }
+}
+#endif
 
 /*
 void outputFunc(const Star *star) {
@@ -38,10 +99,10 @@ void outputFunc(const Star *star) {
                    star->typeName(),
                    star->position.magnitude(),
                    pow(star->luminosity, 0.33000001311302185),
-                   star->name);
+                   star->name());
     }
     if (hasPlanets) {
-        for (auto &planet: star->planets) {
+        for (auto &planet: star->planets()) {
             fmt::print(output[0],
                        "{},{},{},{},{},{}",
                        seed,
@@ -59,48 +120,126 @@ void outputFunc(const Star *star) {
 };
 */
 
-static void calc() {
-    dspugen::Galaxy::initThread();
-    dspugen::Star::initThread();
-    dspugen::Planet::initThread();
-    while (true) {
-        int seed;
-        {
-            std::unique_lock lk(mutex1);
-            if (current >= currMax) {
-                if (++currIndex >= totalSize) {
-                    break;
-                }
-                current = (*seedsToCheck)[currIndex].first;
-                currMax = (*seedsToCheck)[currIndex].second;
-                seed = current++;
-            } else {
-                seed = current++;
+/* Generate only what the loaded plugins read, if all of them tell.
+ * Options given on the command line are kept on top */
+static void applyPluginRequirements() {
+    uint32_t mask;
+    if (!pluginRequirements(mask)) return;
+    auto &s = dspugen::settings;
+    s.genName = s.genName || (mask & RequireNames);
+    s.hasPlanets = s.hasPlanets || (mask & RequirePlanets);
+    s.noVeins = !(mask & RequireVeins);
+    s.genGas = mask & RequireGas;
+    s.noPosition = s.noPosition || !(mask & (RequirePositions | RequireGas));
+    s.birthOnly = s.birthOnly || (mask & RequireBirthOnly);
+    fmt::print(std::cerr, "Generating from plugin requirements: names={} positions={} planets={} veins={} gas={} birthOnly={}\n",
+               s.genName, !s.noPosition, s.hasPlanets, !s.noVeins, s.genGas, s.birthOnly);
+}
+
+/* Takes up to `max` seeds of the current star count range, returns how many */
+static int takeSeeds(int *seeds, int max) {
+    std::unique_lock lk(mutex1);
+    int count = 0;
+    while (count < max) {
+        if (current >= currMax) {
+            if (++currIndex >= totalSize) {
+                break;
             }
+            current = (*seedsToCheck)[currIndex].first;
+            currMax = (*seedsToCheck)[currIndex].second;
         }
-        if (seed % 500000 == 0) {
-            fmt::print(std::cerr, "Processed to: {},{}. Currently found: {}. {}ms elapsed.\n", seed, starCount, found, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - *startTime).count());
+        seeds[count++] = current++;
+    }
+    return count;
+}
+
+/* Runs the filters over a created galaxy, writes it out if it passes and releases it */
+static void checkGalaxy(dspugen::GenContext &ctx, dspugen::Galaxy *galaxy) {
+    auto passed = galaxy && runFilters(galaxy);
+    if (passed && galaxy->starCountAssumed) {
+        /* Rebuilt galaxies go through the filters again with the real star count */
+        auto *verified = galaxy->verifyStarCount(ctx, dspugen::DefaultAlgoVersion);
+        if (verified != galaxy) {
+            galaxy = verified;
+            passed = galaxy && runFilters(galaxy);
         }
-        auto galaxy = dspugen::Galaxy::create(dspugen::DefaultAlgoVersion, seed, starCount);
-        if (!runFilters(galaxy)) {
-            galaxy->release();
-            continue;
+    }
+    if (!passed) {
+        if (galaxy) galaxy->release();
+        return;
+    }
+    {
+        std::unique_lock lk(mutex2);
+        ++found;
+        runOutput(galaxy);
+        fmt::print(*outputStream, "{},{}\n", galaxy->seed, galaxy->starCount);
+    }
+    galaxy->release();
+}
+
+static void calc() {
+    dspugen::GenContext ctx(dspugen::settings);
+    if (hasSkeletonFilters()) {
+        ctx.skeletonFilter = [](const dspugen::GalaxySkeleton &skeleton, void *) {
+            return runSkeletonFilters(skeleton);
+        };
+    }
+    if (hasStarStreamFilters()) {
+        ctx.starFilter = [](const dspugen::Star &star, void *) {
+            return runStarStreamFilters(star);
+        };
+    }
+    if (hasSystemStreamFilters()) {
+        ctx.systemFilter = [](const dspugen::Star &star, void *) {
+            return runSystemStreamFilters(star);
+        };
+    }
+    uint64_t processed = 0;
+    std::vector<int> seeds(batchGalaxies ? batchSize : 1);
+    std::vector<dspugen::Galaxy*> galaxies(seeds.size());
+    while (true) {
+        auto count = takeSeeds(seeds.data(), static_cast<int>(seeds.size()));
+        if (count == 0) break;
+        for (int i = 0; i < count; i++) {
+            if (seeds[i] % 500000 == 0) {
+                fmt::print(std::cerr, "Processed to: {},{}. Currently found: {}. {}ms elapsed.\n", seeds[i], starCount, found, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - *startTime).count());
+            }
         }
-        {
-            std::unique_lock lk(mutex2);
-            ++found;
-            runOutput(galaxy);
-            fmt::print(*outputStream, "{},{}\n", seed, galaxy->starCount);
+#if defined(DSPUGEN_ALLOC_CHECK)
+        auto allocCount = dspugen::util::heapAllocCount;
+        auto warmedUp = processed;
+#endif
+        if (sweepGalaxies) {
+            sweepGalaxies(ctx, dspugen::DefaultAlgoVersion, seeds[0], starCount, sweepMaxStars,
+                          [](dspugen::Galaxy *galaxy, int, void *userdata) {
+                              checkGalaxy(*static_cast<dspugen::GenContext*>(userdata), galaxy);
+                          }, &ctx);
+            processed += sweepMaxStars - starCount + 1;
+        } else if (batchGalaxies) {
+            batchGalaxies(ctx, dspugen::DefaultAlgoVersion, seeds.data(), count, starCount, galaxies.data());
+            for (int i = 0; i < count; i++) {
+                checkGalaxy(ctx, galaxies[i]);
+            }
+            processed += count;
+        } else {
+            checkGalaxy(ctx, createGalaxy(ctx, dspugen::DefaultAlgoVersion, seeds[0], starCount));
+            ++processed;
         }
-        galaxy->release();
+#if defined(DSPUGEN_ALLOC_CHECK)
+        checkAllocs(seeds[0], warmedUp, allocCount);
+#endif
     }
-    dspugen::Planet::releaseThread();
-    dspugen::Star::releaseThread();
-    dspugen::Galaxy::releaseThread();
+#if defined(DSPUGEN_RNG_STATS)
+    rngInitTotal += dspugen::util::DotNet35Random::initCount;
+    galaxyTotal += processed;
+    dspugen::util::DotNet35Random::initCount = 0;
+#endif
 }
 
 static void pose() {
+    dspugen::GenContext ctx(dspugen::settings);
     std::vector<dspugen::VectorLF3> poses;
+    uint64_t processed = 0;
     while (true) {
         int seed;
         {
@@ -116,12 +255,18 @@ static void pose() {
                 seed = current++;
             }
         }
-        dspugen::Galaxy::GeneratePoses(dspugen::DefaultAlgoVersion, seed, starCount, poses);
+        dspugen::Galaxy::GeneratePoses(ctx, dspugen::DefaultAlgoVersion, seed, starCount, poses);
+        ++processed;
         runPoseFilters(seed, starCount, poses);
         if (seed % 500000 == 0) {
             fmt::print(std::cerr, "Processed to: {},{}. {}ms elapsed.\n", seed, starCount, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - *startTime).count());
         }
     }
+#if defined(DSPUGEN_RNG_STATS)
+    rngInitTotal += dspugen::util::DotNet35Random::initCount;
+    galaxyTotal += processed;
+    dspugen::util::DotNet35Random::initCount = 0;
+#endif
 }
 
 void addSeedByString(const std::string &buf, int stars = 64) {
@@ -149,13 +294,15 @@ void addSeedByString(const std::string &buf, int stars = 64) {
                 starsTo = static_cast<int>(std::strtol(buf.c_str() + pos2 + 1, nullptr, 10));
             }
         }
-        if (starsTo > stars) {
+        if (starsTo > stars && sweep) {
+            seedsToCheckMap[{stars, starsTo}].emplace_back(from, to + 1);
+        } else if (starsTo > stars) {
             while (stars <= starsTo) {
-                seedsToCheckMap[stars].emplace_back(from, to + 1);
+                seedsToCheckMap[{stars, stars}].emplace_back(from, to + 1);
                 ++stars;
             }
         } else {
-            seedsToCheckMap[stars].emplace_back(from, to + 1);
+            seedsToCheckMap[{stars, stars}].emplace_back(from, to + 1);
         }
     }
 }
@@ -209,13 +356,17 @@ int main(int argc, char *argv[]) {
         {"birth", no_argument, nullptr, 'b'},
         {"planets", no_argument, nullptr, 'p'},
         {"names", no_argument, nullptr, 'n'},
+        {"sweep", no_argument, nullptr, 's'},
+        {"batch", required_argument, nullptr, 'B'},
+        {"protos", required_argument, nullptr, 'j'},
         {nullptr},
     };
     char opt;
     std::string inputFilename;
     std::string seedFilename = "seeds.csv";
+    std::string protoDir;
     int threadCount = 0;
-    while ((opt = getopt_long(argc, argv, ":t:i:o:bpPZn", longOptions, nullptr)) != -1) {
+    while ((opt = getopt_long(argc, argv, ":t:i:o:B:j:bpPZns", longOptions, nullptr)) != -1) {
         switch (opt) {
         case ':':
             fmt::print(std::cerr, "mssing argument for {}\n", static_cast<char>(optopt));
@@ -241,6 +392,15 @@ int main(int argc, char *argv[]) {
         case 'b':
             dspugen::settings.birthOnly = true;
             break;
+        case 's':
+            sweep = true;
+            break;
+        case 'B':
+            batchSize = std::stoi(optarg);
+            break;
+        case 'j':
+            protoDir = fmt::format("{}", optarg);
+            break;
         case 'o':
             seedFilename = fmt::format("{}", optarg);
             break;
@@ -252,17 +412,26 @@ int main(int argc, char *argv[]) {
         }
     }
     if (optind >= argc && inputFilename.empty()) {
-        fmt::print(std::cerr, "Usage: DSPSeedCalc [-t threads] [-n] [-i filename] [-b] [-p] [-P] [-o seeds.csv] [ranges...]\n");
+        fmt::print(std::cerr, "Usage: DSPSeedCalc [-t threads] [-n] [-i filename] [-b] [-p] [-P] [-s] [-B size] [-j dir] [-o seeds.csv] [ranges...]\n");
         fmt::print(std::cerr, "          Ranges format: a-b[,starCount]. starCount is 64 by default, can be range.   e.g. 0-1000 / 333-666,32\n");
         fmt::print(std::cerr, "      -t  Threads to use, 0 for default, which means (logic CPU threads - 1)\n");
-        fmt::print(std::cerr, "      -n  Generate names for stars(which will reduce calculation speed)\n");
+        fmt::print(std::cerr, "      -n  Generate names for stars\n");
         fmt::print(std::cerr, "      -b  Generate only birth star\n");
         fmt::print(std::cerr, "      -p  Generate planet info for plugins use\n");
         fmt::print(std::cerr, "      -P  Generate only poses, support only pose() filters\n");
+        fmt::print(std::cerr, "      -s  Generate each seed once for all star counts of a range, e.g. 0-1000,32-64\n");
+        fmt::print(std::cerr, "      -B  Seeds generated together by each thread, stage by stage, 64 by default, 1 to disable\n");
+        fmt::print(std::cerr, "      -j  Load prototypes from the game data JSON files in dir instead of the built-in ones\n");
         fmt::print(std::cerr, " Note: You need to supply either [filename] or [ranges...]\n");
         return -1;
     }
     loadFilters();
+    sweep = sweep && !poseOnly;
+    /* Seeds of a batch all begin before any is filtered, which per seed plugin state can not follow */
+    if (hasSkeletonFilters() && hasSeedStates()) batchSize = 1;
+    if (!poseOnly) applyPluginRequirements();
+    /* Planets are what system stream filters look at */
+    if (hasSystemStreamFilters()) dspugen::settings.hasPlanets = true;
     for (auto oind = optind; oind < argc; oind++) {
         addSeedByString(argv[oind]);
     }
@@ -270,7 +439,12 @@ int main(int argc, char *argv[]) {
         readFromInputFile(inputFilename);
     }
     sortSeeds();
-    dspugen::loadProtoSets();
+    if (protoDir.empty()) {
+        dspugen::loadProtoSets();
+    } else if (!dspugen::loadProtoSets(protoDir)) {
+        fmt::print(std::cerr, "Unable to load prototypes from {}!\n", protoDir);
+        return -1;
+    }
 /*
     if (hasPlanets) {
         output = std::ofstream(planetFilename);
@@ -290,7 +464,11 @@ int main(int argc, char *argv[]) {
     startTime = new std::chrono::time_point<std::chrono::steady_clock>(std::chrono::steady_clock::now());
     for (auto &p: seedsToCheckMap) {
         auto &seeds = p.second;
-        starCount = p.first;
+        starCount = p.first.first;
+        sweepMaxStars = p.first.second;
+        createGalaxy = dspugen::Galaxy::creator(dspugen::settings, starCount);
+        sweepGalaxies = sweepMaxStars > starCount ? dspugen::Galaxy::sweeper(dspugen::settings) : nullptr;
+        batchGalaxies = !sweepGalaxies && batchSize > 1 ? dspugen::Galaxy::batcher(dspugen::settings, starCount) : nullptr;
         totalSize = seeds.size();
         if (totalSize) {
             current = seeds[0].first;
@@ -313,11 +491,22 @@ int main(int argc, char *argv[]) {
     int count = 0;
     for (auto &sp: seedsToCheckMap) {
         for (auto &p: sp.second) {
-            count += p.second - p.first;
+            count += (p.second - p.first) * (sp.first.second - sp.first.first + 1);
         }
     }
     fmt::print(std::cerr, "Output file: {}\n", seedFilename);
     fmt::print(std::cerr, "============\n{}ms used, {} found from {} processed seeds.\n", std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(), found, count);
+#if defined(DSPUGEN_RNG_STATS)
+    if (galaxyTotal > 0) {
+        fmt::print(std::cerr, "{} random generators seeded, {:.2f} per galaxy.\n", rngInitTotal.load(), double(rngInitTotal.load()) / double(galaxyTotal.load()));
+    }
+#endif
     delete startTime;
+#if defined(DSPUGEN_ALLOC_CHECK)
+    if (allocCheckFailed) {
+        fmt::print(std::cerr, "Allocation check failed.\n");
+        return 1;
+    }
+#endif
     return 0;
 }
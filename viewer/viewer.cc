@@ -1,7 +1,10 @@
+#include <algorithm>
 #include <cfloat>
 #include "galaxy.hh"
+#include "gencontext.hh"
 #include "protoset.hh"
 #include "settings.hh"
+#include "util/threadpool.hh"
 
 #include <raylib.h>
 #include <rcamera.h>
@@ -131,10 +134,11 @@ int main(int, char *[]) {
     dspugen::settings.genName = true;
     dspugen::loadProtoSets();
 
-    dspugen::Galaxy::initThread();
-    dspugen::Star::initThread();
-    dspugen::Planet::initThread();
-    auto *galaxy = dspugen::Galaxy::create(dspugen::DefaultAlgoVersion, 0, 64);
+    /* One galaxy to show, spread its stars over the cores */
+    dspugen::util::ThreadPool pool(std::max(1, static_cast<int>(std::thread::hardware_concurrency())) - 1);
+    dspugen::GenContext ctx(dspugen::settings);
+    ctx.pool = &pool;
+    auto *galaxy = dspugen::Galaxy::create(ctx, dspugen::DefaultAlgoVersion, 0, 64);
     struct StarData {
         int id;
         Vector3 position;
@@ -159,7 +163,7 @@ int main(int, char *[]) {
                 c = Color { 0, 0, 0, 255 };
                 break;
             default:
-                GradiantColor(s->color, c);
+                GradiantColor(s->color(), c);
         }
         float radius;
         switch (s->type) {
@@ -176,7 +180,7 @@ int main(int, char *[]) {
             default:
                 radius = 1.5f;
         }
-        auto v2 = MeasureTextEx(font, s->name.c_str(), 18, 0);
+        auto v2 = MeasureTextEx(font, s->name().data(), 18, 0);
         stars.emplace_back(StarData { s->id, p, radius * 0.2f, c, v2.x, s });
     }
 
@@ -247,21 +251,21 @@ int main(int, char *[]) {
                 auto pos2d = GetWorldToScreen(s.position, camera);
                 pos2d.y = pos2d.y - 20.0f;
                 pos2d.x -= s.nameWidth * 0.5f;
-                DrawTextEx(font, s.data->name.c_str(), pos2d, 18, 0, WHITE);
+                DrawTextEx(font, s.data->name().data(), pos2d, 18, 0, WHITE);
             }
         } else {
             if (selectedStar) {
                 auto pos2d = GetWorldToScreen(selectedStar->position, camera);
                 pos2d.y = pos2d.y - 20.0f;
                 pos2d.x -= selectedStar->nameWidth * 0.5f;
-                DrawTextEx(font, selectedStar->data->name.c_str(), pos2d, 18, 0, WHITE);
+                DrawTextEx(font, selectedStar->data->name().data(), pos2d, 18, 0, WHITE);
             }
 
             if (collisionStar && collisionStar != selectedStar) {
                 auto pos2d = GetWorldToScreen(collisionStar->position, camera);
                 pos2d.y = pos2d.y - 20.0f;
                 pos2d.x -= collisionStar->nameWidth * 0.5f;
-                DrawTextEx(font, collisionStar->data->name.c_str(), pos2d, 18, 0, LIGHTGRAY);
+                DrawTextEx(font, collisionStar->data->name().data(), pos2d, 18, 0, LIGHTGRAY);
             }
         }
 